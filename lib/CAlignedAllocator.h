@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+/*
+ * Allocator for std::vector whose memory starts on an Alignment byte
+ * boundary, so SIMD kernels can use full-width loads on the data.
+*/
+template <typename T, std::size_t Alignment = 64>
+class CAlignedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = CAlignedAllocator<U, Alignment>;
+    };
+
+    CAlignedAllocator() noexcept = default;
+
+    template <typename U>
+    CAlignedAllocator(const CAlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const CAlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+};
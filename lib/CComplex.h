@@ -1,47 +1,101 @@
 #pragma once
 
+#include <cmath>
+#include <complex>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <vector>
+
+/*
+ * Complex number with the memory layout of std::complex<double>. All
+ * arithmetic is inline and constexpr, copies are plain memory copies.
+*/
 class CComplex {
 private:
     static const bool DEBUG;
-    static std::vector<CComplex> fftRecursive(const std::vector<CComplex>& values, bool inverse);
     double m_re;
     double m_im;
 
 public:
-    CComplex();
-    CComplex(double re, double im);
-    CComplex(double phi);
-    CComplex(const CComplex& c);
-    ~CComplex();
-
-    double re() const;
-    double im() const;
-    double abs() const;
-    double absSq() const;
-
-    CComplex& operator=(const CComplex& c);
-    CComplex& operator+=(const CComplex& c);
-    CComplex& operator-=(const CComplex& c);
-    CComplex& operator*=(const CComplex& c);
-    CComplex& operator/=(const CComplex& c);
-    CComplex& operator*=(double d);
-    CComplex& operator/=(double d);
-
-    CComplex operator+(const CComplex& c) const;
-    CComplex operator-(const CComplex& c) const;
-    CComplex operator*(const CComplex& c) const;
-    CComplex operator/(const CComplex& c) const;
-    CComplex operator*(double d) const;
-    CComplex operator/(double d) const;
-
-    bool operator==(const CComplex& c) const;
-    bool operator!=(const CComplex& c) const;
+    constexpr CComplex() : m_re(0), m_im(0) {}
+    constexpr CComplex(double re, double im) : m_re(re), m_im(im) {}
+    CComplex(double phi) : m_re(std::cos(phi)), m_im(std::sin(phi)) {}
+    constexpr CComplex(const CComplex& c) = default;
+    ~CComplex() = default;
+
+    constexpr double re() const { return m_re; }
+    constexpr double im() const { return m_im; }
+    double abs() const { return std::sqrt(absSq()); }
+    constexpr double absSq() const { return m_re * m_re + m_im * m_im; }
+
+    constexpr CComplex& operator=(const CComplex& c) = default;
+
+    constexpr CComplex& operator+=(const CComplex& c) {
+        m_re += c.m_re;
+        m_im += c.m_im;
+        return *this;
+    }
+
+    constexpr CComplex& operator-=(const CComplex& c) {
+        m_re -= c.m_re;
+        m_im -= c.m_im;
+        return *this;
+    }
+
+    constexpr CComplex& operator*=(const CComplex& c) {
+        double re = m_re * c.m_re - m_im * c.m_im;
+        double im = m_re * c.m_im + m_im * c.m_re;
+        m_re = re;
+        m_im = im;
+        return *this;
+    }
+
+    constexpr CComplex& operator/=(const CComplex& c) {
+        double re = (m_re * c.m_re + m_im * c.m_im) / c.absSq();
+        double im = (m_im * c.m_re - m_re * c.m_im) / c.absSq();
+        m_re = re;
+        m_im = im;
+        return *this;
+    }
+
+    constexpr CComplex& operator*=(double d) {
+        m_re *= d;
+        m_im *= d;
+        return *this;
+    }
+
+    constexpr CComplex& operator/=(double d) {
+        m_re /= d;
+        m_im /= d;
+        return *this;
+    }
+
+    constexpr CComplex operator+(const CComplex& c) const { return CComplex(*this) += c; }
+    constexpr CComplex operator-(const CComplex& c) const { return CComplex(*this) -= c; }
+    constexpr CComplex operator*(const CComplex& c) const { return CComplex(*this) *= c; }
+    constexpr CComplex operator/(const CComplex& c) const { return CComplex(*this) /= c; }
+    constexpr CComplex operator*(double d) const { return CComplex(*this) *= d; }
+    constexpr CComplex operator/(double d) const { return CComplex(*this) /= d; }
+
+    constexpr bool operator==(const CComplex& c) const { return m_re == c.m_re && m_im == c.m_im; }
+    constexpr bool operator!=(const CComplex& c) const { return !(*this == c); }
 
     std::string to_string() const;
 
     static std::vector<CComplex> dft(const std::vector<CComplex>& values);
     static std::vector<CComplex> idft(const std::vector<CComplex>& values);
     static std::vector<CComplex> fft(const std::vector<CComplex>& values, bool inverse = false);
+    static void fftInPlace(std::span<CComplex> values, bool inverse = false);
+    // element j of signal b is data[b * dist + j * stride], signals must not overlap
+    static void fftBatch(std::span<CComplex> data, int n, int howmany, int stride, int dist, bool inverse = false);
+    static void dftBatch(std::span<CComplex> data, int n, int howmany, int stride, int dist, bool inverse = false);
+    static std::vector<CComplex> fft2d(const std::vector<CComplex>& values, int rows, int cols, bool inverse = false);
+    static std::vector<CComplex> rfft(const std::vector<double>& values);
+    static std::vector<double> irfft(const std::vector<CComplex>& spectrum, int N);
 };
+
+static_assert(std::is_trivially_copyable_v<CComplex>);
+static_assert(std::is_standard_layout_v<CComplex>);
+static_assert(sizeof(CComplex) == sizeof(std::complex<double>));
+static_assert(alignof(CComplex) == alignof(std::complex<double>));
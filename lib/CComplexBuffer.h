@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CAlignedAllocator.h"
+#include "CComplex.h"
+#include <vector>
+
+/*
+ * Stores complex vectors as separate, 64 byte aligned arrays of real and
+ * imaginary parts so transforms can process several values per instruction.
+*/
+class CComplexBuffer {
+private:
+    std::vector<double, CAlignedAllocator<double, 64>> m_re;
+    std::vector<double, CAlignedAllocator<double, 64>> m_im;
+
+public:
+    CComplexBuffer(int size);
+    CComplexBuffer(const std::vector<CComplex>& values);
+
+    int size() const;
+    double* re();
+    double* im();
+    const double* re() const;
+    const double* im() const;
+    CComplex get(int index) const;
+    void set(int index, const CComplex& value);
+    std::vector<CComplex> toVector() const;
+
+    void fft(bool inverse = false);
+};
@@ -1,20 +1,496 @@
 #pragma once
 
 #include "CMyVector.h"
+#include "CTrajectory.h"
+#include "HelperOutput.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+/*
+ * Explicit Runge-Kutta method with S stages. error holds b - b_hat for an
+ * embedded method of order order - 1 and is zero if there is none. With
+ * fsal the last stage is f at the new point, so it is the first stage of
+ * the next step. dense gives the continuous extension between two steps,
+ * h * sum dense_j k_j is the correction r5 of CTrajectory, zero means
+ * cubic Hermite interpolation.
+*/
+template<int S>
+struct CButcherTableau {
+    std::array<double, S> c;
+    std::array<std::array<double, S>, S> a;
+    std::array<double, S> b;
+    std::array<double, S> error;
+    std::array<double, S> dense;
+    int order;
+    bool fsal;
+};
+
+/*
+ * Solves y' = f(y, x) for systems and y^(n) = f(y, x) for nth order
+ * equations, where y holds y, y', ..., y^(n-1).
+ *
+ * V is the state vector, CMyVector or CFixedVector<N> for systems whose
+ * dimension is known at compile time. The latter keeps every step on the
+ * stack. CDGLSolver solver(f) deduces CMyVector.
+ *
+ * The static euler() / heun() take the right hand side as any callable by
+ * reference, so it is inlined into the step loop. Whether f is a system
+ * or an nth order equation follows from its return type at compile time.
+ * A CDGLSolver object stores f in a std::function and forwards to them.
+ *
+ * rungeKutta() is the classic fourth order method with a fixed step.
+ * dormandPrince() (order 5 with an embedded 4) and bogackiShampine()
+ * (order 3 with an embedded 2) choose the step size themselves, so that
+ * the local error estimate stays below tolerance * (1 + |y_i|) in every
+ * component.
+ *
+ * trajectory() integrates once with Dormand-Prince, or with a fixed
+ * number of Runge-Kutta steps, and keeps every step, so the solution can
+ * be evaluated at any x in between (see CTrajectory).
+*/
+template<typename V = CMyVector>
 class CDGLSolver {
 private:
-    static const bool DEBUG; 
-    std::function<CMyVector(CMyVector y, double x)> dgl;
-    std::function<double(CMyVector y, double x)> dgl_nth_order;
-    CMyVector derivatives(const CMyVector y, double x) const;
+    static constexpr bool DEBUG = false;
+    std::function<V(const V& y, double x)> dgl;
+    std::function<double(const V& y, double x)> dgl_nth_order;
     bool is_system;
 
+    static constexpr double SAFETY = 0.9;
+    static constexpr double MIN_FACTOR = 0.2;
+    static constexpr double MAX_FACTOR = 5.0;
+
+    static constexpr CButcherTableau<4> RUNGE_KUTTA = {
+        {0, 1.0 / 2, 1.0 / 2, 1},
+        {{{}, {1.0 / 2}, {0, 1.0 / 2}, {0, 0, 1}}},
+        {1.0 / 6, 1.0 / 3, 1.0 / 3, 1.0 / 6},
+        {},
+        {},
+        4, false
+    };
+
+    static constexpr CButcherTableau<4> BOGACKI_SHAMPINE = {
+        {0, 1.0 / 2, 3.0 / 4, 1},
+        {{{}, {1.0 / 2}, {0, 3.0 / 4}, {2.0 / 9, 1.0 / 3, 4.0 / 9}}},
+        {2.0 / 9, 1.0 / 3, 4.0 / 9, 0},
+        {-5.0 / 72, 1.0 / 12, 1.0 / 9, -1.0 / 8},
+        {},
+        3, true
+    };
+
+    static constexpr CButcherTableau<7> DORMAND_PRINCE = {
+        {0, 1.0 / 5, 3.0 / 10, 4.0 / 5, 8.0 / 9, 1, 1},
+        {{{},
+          {1.0 / 5},
+          {3.0 / 40, 9.0 / 40},
+          {44.0 / 45, -56.0 / 15, 32.0 / 9},
+          {19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729},
+          {9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656},
+          {35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84}}},
+        {35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84, 0},
+        {71.0 / 57600, 0, -71.0 / 16695, 71.0 / 1920, -17253.0 / 339200, 22.0 / 525, -1.0 / 40},
+        {-12715105075.0 / 11282082432, 0, 87487479700.0 / 32700410799, -10690763975.0 / 1880347072,
+         701980252875.0 / 199316789632, -1453857185.0 / 822651844, 69997945.0 / 29380423},
+        5, true
+    };
+
+    template<typename F>
+    static V derivatives(const F& f, const V& y, double x);
+
+    template<typename F, int S>
+    static void step(const F& f, const CButcherTableau<S>& tableau, double x, const V& y, double h, std::vector<V>& k, V& yNew);
+    template<int S>
+    static double errorNorm(const CButcherTableau<S>& tableau, const V& y, const V& yNew, const std::vector<V>& k, double h, double tolerance);
+    static double initialStep(const V& y, const V& dy, double tolerance, double span);
+    template<typename F, int S>
+    static V adaptive(const F& f, const CButcherTableau<S>& tableau, double xStart, double xEnd, const V& yStart, double tolerance, CTrajectory<V>* trajectory = nullptr);
+    template<typename F>
+    static V rungeKutta(const F& f, double xStart, double xEnd, int steps, const V& yStart, CTrajectory<V>* trajectory);
+
 public:
-    CDGLSolver(std::function<CMyVector(const CMyVector y, double x)> dgl);
-    CDGLSolver(std::function<double(const CMyVector y, double x)> dgl);
-    CMyVector euler(double xStart, double xEnd, int steps, const CMyVector yStart) const;
-    CMyVector heun(double xStart, double xEnd, int steps, const CMyVector yStart) const; 
+    CDGLSolver(std::type_identity_t<std::function<V(const V& y, double x)>> dgl);
+    CDGLSolver(std::type_identity_t<std::function<double(const V& y, double x)>> dgl);
+    V euler(double xStart, double xEnd, int steps, const V& yStart) const;
+    V heun(double xStart, double xEnd, int steps, const V& yStart) const;
+    V rungeKutta(double xStart, double xEnd, int steps, const V& yStart) const;
+    V dormandPrince(double xStart, double xEnd, const V& yStart, double tolerance = 1e-8) const;
+    V bogackiShampine(double xStart, double xEnd, const V& yStart, double tolerance = 1e-6) const;
+    CTrajectory<V> trajectory(double xStart, double xEnd, const V& yStart, double tolerance = 1e-8) const;
+    CTrajectory<V> trajectory(double xStart, double xEnd, int steps, const V& yStart) const;
+
+    template<typename F>
+    static V euler(const F& f, double xStart, double xEnd, int steps, const V& yStart);
+    template<typename F>
+    static V heun(const F& f, double xStart, double xEnd, int steps, const V& yStart);
+    template<typename F>
+    static V rungeKutta(const F& f, double xStart, double xEnd, int steps, const V& yStart);
+    template<typename F>
+    static V dormandPrince(const F& f, double xStart, double xEnd, const V& yStart, double tolerance = 1e-8);
+    template<typename F>
+    static V bogackiShampine(const F& f, double xStart, double xEnd, const V& yStart, double tolerance = 1e-6);
+    template<typename F>
+    static CTrajectory<V> trajectory(const F& f, double xStart, double xEnd, const V& yStart, double tolerance = 1e-8);
+    template<typename F>
+    static CTrajectory<V> trajectory(const F& f, double xStart, double xEnd, int steps, const V& yStart);
 };
 
+template<typename V>
+CDGLSolver<V>::CDGLSolver(std::type_identity_t<std::function<V(const V& y, double x)>> dgl)
+    : dgl(dgl), is_system(true) {}
+
+template<typename V>
+CDGLSolver<V>::CDGLSolver(std::type_identity_t<std::function<double(const V& y, double x)>> dgl)
+    : dgl_nth_order(dgl), is_system(false) {}
+
+template<typename V>
+template<typename F>
+V CDGLSolver<V>::derivatives(const F& f, const V& y, double x) {
+    using R = std::remove_cvref_t<std::invoke_result_t<const F&, const V&, double>>;
+    // an expression node may still refer to locals of f, it has to be converted inside f
+    static_assert(std::is_same_v<R, V> || std::is_arithmetic_v<R>, "The right hand side must return the vector type or a number.");
+
+    if constexpr (!std::is_arithmetic_v<R>) {
+        return f(y, x);
+    } else {
+        int n = y.dimension();
+        V result(n);
+
+        for (int i = 0; i < n - 1; ++i) {
+            result[i] = y.get(i + 1); // y_i' = y_(i+1)
+        }
+
+        result[n - 1] = f(y, x);
+
+        return result;
+    }
+}
+
+template<typename V>
+V CDGLSolver<V>::euler(double xStart, double xEnd, int steps, const V& yStart) const {
+    if (is_system) return euler(dgl, xStart, xEnd, steps, yStart);
+    return euler(dgl_nth_order, xStart, xEnd, steps, yStart);
+}
+
+template<typename V>
+V CDGLSolver<V>::heun(double xStart, double xEnd, int steps, const V& yStart) const {
+    if (is_system) return heun(dgl, xStart, xEnd, steps, yStart);
+    return heun(dgl_nth_order, xStart, xEnd, steps, yStart);
+}
+
+template<typename V>
+V CDGLSolver<V>::rungeKutta(double xStart, double xEnd, int steps, const V& yStart) const {
+    if (is_system) return rungeKutta(dgl, xStart, xEnd, steps, yStart);
+    return rungeKutta(dgl_nth_order, xStart, xEnd, steps, yStart);
+}
+
+template<typename V>
+V CDGLSolver<V>::dormandPrince(double xStart, double xEnd, const V& yStart, double tolerance) const {
+    if (is_system) return dormandPrince(dgl, xStart, xEnd, yStart, tolerance);
+    return dormandPrince(dgl_nth_order, xStart, xEnd, yStart, tolerance);
+}
+
+template<typename V>
+V CDGLSolver<V>::bogackiShampine(double xStart, double xEnd, const V& yStart, double tolerance) const {
+    if (is_system) return bogackiShampine(dgl, xStart, xEnd, yStart, tolerance);
+    return bogackiShampine(dgl_nth_order, xStart, xEnd, yStart, tolerance);
+}
+
+template<typename V>
+CTrajectory<V> CDGLSolver<V>::trajectory(double xStart, double xEnd, const V& yStart, double tolerance) const {
+    if (is_system) return trajectory(dgl, xStart, xEnd, yStart, tolerance);
+    return trajectory(dgl_nth_order, xStart, xEnd, yStart, tolerance);
+}
+
+template<typename V>
+CTrajectory<V> CDGLSolver<V>::trajectory(double xStart, double xEnd, int steps, const V& yStart) const {
+    if (is_system) return trajectory(dgl, xStart, xEnd, steps, yStart);
+    return trajectory(dgl_nth_order, xStart, xEnd, steps, yStart);
+}
+
+// computes k[1], ..., k[S-1] from k[0] = f(y, x) and the new point yNew
+template<typename V>
+template<typename F, int S>
+void CDGLSolver<V>::step(const F& f, const CButcherTableau<S>& tableau, double x, const V& y, double h, std::vector<V>& k, V& yNew) {
+    for (int i = 1; i < S; ++i) {
+        V stage = y;
+        for (int j = 0; j < i; ++j) {
+            if (tableau.a[i][j] != 0) stage += k[j] * (h * tableau.a[i][j]);
+        }
+
+        k[i] = derivatives(f, stage, x + tableau.c[i] * h);
+    }
+
+    yNew = y;
+    for (int j = 0; j < S; ++j) {
+        if (tableau.b[j] != 0) yNew += k[j] * (h * tableau.b[j]);
+    }
+}
+
+// root mean square of the error estimate relative to tolerance * (1 + |y_i|), a step is accepted at <= 1
+template<typename V>
+template<int S>
+double CDGLSolver<V>::errorNorm(const CButcherTableau<S>& tableau, const V& y, const V& yNew, const std::vector<V>& k, double h, double tolerance) {
+    int n = y.dimension();
+    double sum = 0;
+
+    for (int i = 0; i < n; ++i) {
+        double error = 0;
+        for (int j = 0; j < S; ++j) {
+            error += tableau.error[j] * k[j].get(i);
+        }
+
+        double scale = tolerance * (1 + std::max(std::abs(y.get(i)), std::abs(yNew.get(i))));
+        sum += std::pow(h * error / scale, 2);
+    }
+
+    return n > 0 ? std::sqrt(sum / n) : 0;
+}
+
+// first step from the size of y and y' (Hairer, Norsett, Wanner: Solving ODEs I, II.4)
+template<typename V>
+double CDGLSolver<V>::initialStep(const V& y, const V& dy, double tolerance, double span) {
+    double d0 = 0;
+    double d1 = 0;
+
+    for (int i = 0; i < y.dimension(); ++i) {
+        double scale = tolerance * (1 + std::abs(y.get(i)));
+        d0 += std::pow(y.get(i) / scale, 2);
+        d1 += std::pow(dy.get(i) / scale, 2);
+    }
+
+    double h = (d0 < 1e-10 || d1 < 1e-10) ? 1e-6 : 0.01 * std::sqrt(d0 / d1);
+    return std::min(h, span);
+}
+
+template<typename V>
+template<typename F, int S>
+V CDGLSolver<V>::adaptive(const F& f, const CButcherTableau<S>& tableau, double xStart, double xEnd, const V& yStart, double tolerance, CTrajectory<V>* trajectory) {
+    if (!(tolerance > 0)) {
+        throw std::invalid_argument("Tolerance must be positive.");
+    }
+
+    Helper::OutputMute mute(!DEBUG);
+
+    double direction = xEnd < xStart ? -1 : 1;
+    double x = xStart;
+    V y = yStart;
+    V yNew = yStart;
+    std::vector<V> k(S, yStart);
+    k[0] = derivatives(f, y, x);
+
+    double h = initialStep(y, k[0], tolerance, std::abs(xEnd - xStart));
+    int accepted = 0;
+    int rejected = 0;
+
+    while (x != xEnd) {
+        bool last = h >= std::abs(xEnd - x);
+        double size = last ? std::abs(xEnd - x) : h;
+        if (x + direction * size == x) {
+            throw std::runtime_error("Step size underflow at x = " + std::to_string(x) + ".");
+        }
+
+        step(f, tableau, x, y, direction * size, k, yNew);
+        double error = errorNorm(tableau, y, yNew, k, size, tolerance);
+        // a non-finite estimate (f returned inf or NaN) shrinks the step until it underflows
+        double factor = error == 0 ? MAX_FACTOR
+            : std::isfinite(error) ? std::clamp(SAFETY * std::pow(error, -1.0 / tableau.order), MIN_FACTOR, MAX_FACTOR)
+            : MIN_FACTOR;
+
+        if (DEBUG) {
+            std::cout << "\nSchritt bei x = " << x << " mit h = " << direction * size << ":" << std::endl;
+            std::cout << "\tFehler = " << error << (error <= 1 ? " (angenommen)" : " (verworfen)") << std::endl;
+        }
+
+        if (!(error <= 1)) {
+            rejected++;
+            h = size * std::min(1.0, factor);
+            continue;
+        }
+
+        accepted++;
+        double xNew = last ? xEnd : x + direction * size;
+
+        if (trajectory) {
+            V correction(y.dimension());
+            for (int j = 0; j < S; ++j) {
+                if (tableau.dense[j] != 0) correction += k[j] * (direction * size * tableau.dense[j]);
+            }
+
+            trajectory->append(xNew, y, yNew, k[0], tableau.fsal ? k[S - 1] : derivatives(f, yNew, xNew), correction);
+        }
+
+        x = xNew;
+        std::swap(y, yNew);
+        h = size * factor;
+
+        if (tableau.fsal) {
+            std::swap(k[0], k[S - 1]);
+        } else if (x != xEnd) {
+            k[0] = derivatives(f, y, x);
+        }
+    }
+
+    std::cout << "\nEnde bei" << std::endl;
+    std::cout << "\tx = " << xEnd << std::endl;
+    std::cout << "\ty = " << y.to_string() << std::endl;
+    std::cout << "\tSchritte = " << accepted << " (" << rejected << " verworfen)" << std::endl;
+
+    return y;
+}
+
+template<typename V>
+template<typename F>
+V CDGLSolver<V>::euler(const F& f, double xStart, double xEnd, int steps, const V& yStart) {
+    Helper::OutputMute mute(!DEBUG);
+
+    double h = (xEnd - xStart) / steps;
+    V y = yStart;
+
+    std::cout << "h = " << h << std::endl;
+
+    for (int i = 0; i < steps; ++i) {
+        // the step output is only formatted when it is shown
+        if (DEBUG) {
+            std::cout << "\nSchritt " << i << ":" << std::endl;
+            std::cout << "\tx = " << xStart + i * h << std::endl;
+            std::cout << "\ty = " << y.to_string() << std::endl;
+            std::cout << "\ty' = " << derivatives(f, y, xStart + i * h).to_string() << std::endl;
+        }
+
+        y = y + derivatives(f, y, xStart + i * h) * h;
+    }
+    
+    std::cout << "\nEnde bei" << std::endl;
+    std::cout << "\tx = " << xEnd << std::endl;
+    std::cout << "\ty = " << y.to_string() << std::endl;
+    
+    return y;
+}
+
+template<typename V>
+template<typename F>
+V CDGLSolver<V>::heun(const F& f, double xStart, double xEnd, int steps, const V& yStart) {
+    Helper::OutputMute mute(!DEBUG);
+
+    double h = (xEnd - xStart) / steps;
+    V y = yStart;
+
+    std::cout << "h = " << h << std::endl;
+    
+    for (int i = 0; i < steps; ++i) {
+        double x = xStart + i * h;
+
+        V d_start = derivatives(f, y, x);
+        V y_test = y + d_start * h;
+        V d_end = derivatives(f, y_test, x + h);
+        V y_mittel = (d_start + d_end) * 0.5;
+
+        if (DEBUG) {
+            std::cout << "\nSchritt " << i << ":" << std::endl;
+            std::cout << "\tx = " << x << std::endl;
+            std::cout << "\ty = " << y.to_string() << std::endl;
+            std::cout << "\ty'_orig = " << d_start.to_string() << std::endl;
+
+            std::cout << "\n\ty_test = " << y_test.to_string() << std::endl;
+            std::cout << "\ty'_test = " << d_end.to_string() << std::endl;
+
+            std::cout << "\n\ty'_mittel = " << y_mittel.to_string() << std::endl;
+        }
+
+        y = y + y_mittel * h;
+    }
+    
+    std::cout << "\nEnde bei" << std::endl;
+    std::cout << "\tx = " << xEnd << std::endl;
+    std::cout << "\ty = " << y.to_string() << std::endl;
+
+    return y;
+}
+
+template<typename V>
+template<typename F>
+V CDGLSolver<V>::rungeKutta(const F& f, double xStart, double xEnd, int steps, const V& yStart) {
+    return rungeKutta(f, xStart, xEnd, steps, yStart, nullptr);
+}
+
+template<typename V>
+template<typename F>
+V CDGLSolver<V>::rungeKutta(const F& f, double xStart, double xEnd, int steps, const V& yStart, CTrajectory<V>* trajectory) {
+    Helper::OutputMute mute(!DEBUG);
+
+    double h = (xEnd - xStart) / steps;
+    V y = yStart;
+    V yNew = yStart;
+    std::vector<V> k(4, yStart);
+    k[0] = derivatives(f, y, xStart);
+
+    std::cout << "h = " << h << std::endl;
+
+    for (int i = 0; i < steps; ++i) {
+        double x = xStart + i * h;
+        double xNew = i == steps - 1 ? xEnd : xStart + (i + 1) * h;
+
+        step(f, RUNGE_KUTTA, x, y, h, k, yNew);
+
+        if (DEBUG) {
+            std::cout << "\nSchritt " << i << ":" << std::endl;
+            std::cout << "\tx = " << x << std::endl;
+            std::cout << "\ty = " << y.to_string() << std::endl;
+            for (int j = 0; j < 4; ++j) {
+                std::cout << "\tk" << j + 1 << " = " << k[j].to_string() << std::endl;
+            }
+        }
+
+        // f at the new point is the first stage of the next step and y' for the trajectory
+        if (trajectory || i < steps - 1) {
+            V dy = derivatives(f, yNew, xStart + (i + 1) * h);
+            if (trajectory) trajectory->append(xNew, y, yNew, k[0], dy);
+            k[0] = std::move(dy);
+        }
+
+        std::swap(y, yNew);
+    }
+
+    std::cout << "\nEnde bei" << std::endl;
+    std::cout << "\tx = " << xEnd << std::endl;
+    std::cout << "\ty = " << y.to_string() << std::endl;
+
+    return y;
+}
+
+template<typename V>
+template<typename F>
+V CDGLSolver<V>::dormandPrince(const F& f, double xStart, double xEnd, const V& yStart, double tolerance) {
+    return adaptive(f, DORMAND_PRINCE, xStart, xEnd, yStart, tolerance);
+}
+
+template<typename V>
+template<typename F>
+V CDGLSolver<V>::bogackiShampine(const F& f, double xStart, double xEnd, const V& yStart, double tolerance) {
+    return adaptive(f, BOGACKI_SHAMPINE, xStart, xEnd, yStart, tolerance);
+}
+
+template<typename V>
+template<typename F>
+CTrajectory<V> CDGLSolver<V>::trajectory(const F& f, double xStart, double xEnd, const V& yStart, double tolerance) {
+    CTrajectory<V> result(xStart, yStart);
+    adaptive(f, DORMAND_PRINCE, xStart, xEnd, yStart, tolerance, &result);
+    return result;
+}
+
+template<typename V>
+template<typename F>
+CTrajectory<V> CDGLSolver<V>::trajectory(const F& f, double xStart, double xEnd, int steps, const V& yStart) {
+    CTrajectory<V> result(xStart, yStart);
+    rungeKutta(f, xStart, xEnd, steps, yStart, &result);
+    return result;
+}
+
+extern template class CDGLSolver<CMyVector>;
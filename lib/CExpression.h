@@ -0,0 +1,185 @@
+#pragma once
+
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Expression templates for CMyVector and CMyMatrix arithmetic.
+ *
+ * +, -, unary - and the product with a scalar do not compute anything,
+ * they return a small node that remembers its operands. Assigning or
+ * converting the node to CMyVector / CMyMatrix evaluates the whole
+ * expression in one loop into the destination, so y + d * h allocates
+ * only the result and no intermediate vectors.
+ *
+ * Every expression E implements dimension() / element(i) (vectors) or
+ * rows() / columns() / element(i, j) (matrices), element() is not bounds
+ * checked. E::BY_REFERENCE tells whether nodes keep a reference to a
+ * named E (CMyVector, CMyMatrix) or a copy (views and nodes, which are
+ * small). Temporaries are always moved into the node.
+ *
+ * Dimensions are checked when a node is built. A node still refers to the
+ * named vectors and matrices it was built from, so it must be converted
+ * before they go out of scope: a lambda returning d * 0.5 for a local d
+ * has to declare CMyVector as its return type. The solvers reject
+ * callables that return a node instead of a value.
+*/
+template<typename E>
+class CVectorExpression {
+public:
+    const E& self() const { return static_cast<const E&>(*this); }
+    int dimension() const { return self().dimension(); }
+    double element(int index) const { return self().element(index); }
+};
+
+template<typename E>
+class CMatrixExpression {
+public:
+    const E& self() const { return static_cast<const E&>(*this); }
+    int rows() const { return self().rows(); }
+    int columns() const { return self().columns(); }
+    double element(int row, int column) const { return self().element(row, column); }
+};
+
+template<typename T>
+constexpr bool isVectorExpression = std::is_base_of_v<CVectorExpression<std::remove_cvref_t<T>>, std::remove_cvref_t<T>>;
+
+template<typename T>
+constexpr bool isMatrixExpression = std::is_base_of_v<CMatrixExpression<std::remove_cvref_t<T>>, std::remove_cvref_t<T>>;
+
+// how a node stores an operand passed as T&&: named vectors and matrices by reference, everything else by value
+template<typename T>
+using CExpressionOperand = std::conditional_t<std::is_lvalue_reference_v<T> && std::remove_cvref_t<T>::BY_REFERENCE,
+    const std::remove_cvref_t<T>&, std::remove_cvref_t<T>>;
+
+template<typename L, typename R, typename Op>
+class CVectorBinary : public CVectorExpression<CVectorBinary<L, R, Op>> {
+private:
+    L m_left;
+    R m_right;
+
+public:
+    static constexpr bool BY_REFERENCE = false;
+
+    template<typename A, typename B>
+    CVectorBinary(A&& left, B&& right) : m_left(std::forward<A>(left)), m_right(std::forward<B>(right)) {
+        if (m_left.dimension() != m_right.dimension()) {
+            throw std::invalid_argument("Vectors must have the same dimension.");
+        }
+    }
+
+    int dimension() const { return m_left.dimension(); }
+    double element(int index) const { return Op()(m_left.element(index), m_right.element(index)); }
+};
+
+template<typename E>
+class CVectorScaled : public CVectorExpression<CVectorScaled<E>> {
+private:
+    E m_operand;
+    double m_factor;
+
+public:
+    static constexpr bool BY_REFERENCE = false;
+
+    template<typename A>
+    CVectorScaled(A&& operand, double factor) : m_operand(std::forward<A>(operand)), m_factor(factor) {}
+
+    int dimension() const { return m_operand.dimension(); }
+    double element(int index) const { return m_operand.element(index) * m_factor; }
+};
+
+template<typename L, typename R, typename Op>
+class CMatrixBinary : public CMatrixExpression<CMatrixBinary<L, R, Op>> {
+private:
+    L m_left;
+    R m_right;
+
+public:
+    static constexpr bool BY_REFERENCE = false;
+
+    template<typename A, typename B>
+    CMatrixBinary(A&& left, B&& right) : m_left(std::forward<A>(left)), m_right(std::forward<B>(right)) {
+        if (m_left.rows() != m_right.rows() || m_left.columns() != m_right.columns()) {
+            throw std::invalid_argument("Matrices must have the same dimensions.");
+        }
+    }
+
+    int rows() const { return m_left.rows(); }
+    int columns() const { return m_left.columns(); }
+    double element(int row, int column) const { return Op()(m_left.element(row, column), m_right.element(row, column)); }
+};
+
+template<typename E>
+class CMatrixScaled : public CMatrixExpression<CMatrixScaled<E>> {
+private:
+    E m_operand;
+    double m_factor;
+
+public:
+    static constexpr bool BY_REFERENCE = false;
+
+    template<typename A>
+    CMatrixScaled(A&& operand, double factor) : m_operand(std::forward<A>(operand)), m_factor(factor) {}
+
+    int rows() const { return m_operand.rows(); }
+    int columns() const { return m_operand.columns(); }
+    double element(int row, int column) const { return m_operand.element(row, column) * m_factor; }
+};
+
+template<typename L, typename R> requires (isVectorExpression<L> && isVectorExpression<R>)
+CVectorBinary<CExpressionOperand<L>, CExpressionOperand<R>, std::plus<>> operator+(L&& left, R&& right) {
+    return {std::forward<L>(left), std::forward<R>(right)};
+}
+
+template<typename L, typename R> requires (isVectorExpression<L> && isVectorExpression<R>)
+CVectorBinary<CExpressionOperand<L>, CExpressionOperand<R>, std::minus<>> operator-(L&& left, R&& right) {
+    return {std::forward<L>(left), std::forward<R>(right)};
+}
+
+// componentwise product
+template<typename L, typename R> requires (isVectorExpression<L> && isVectorExpression<R>)
+CVectorBinary<CExpressionOperand<L>, CExpressionOperand<R>, std::multiplies<>> operator*(L&& left, R&& right) {
+    return {std::forward<L>(left), std::forward<R>(right)};
+}
+
+template<typename E> requires isVectorExpression<E>
+CVectorScaled<CExpressionOperand<E>> operator*(E&& vector, double factor) {
+    return {std::forward<E>(vector), factor};
+}
+
+template<typename E> requires isVectorExpression<E>
+CVectorScaled<CExpressionOperand<E>> operator*(double factor, E&& vector) {
+    return {std::forward<E>(vector), factor};
+}
+
+template<typename E> requires isVectorExpression<E>
+CVectorScaled<CExpressionOperand<E>> operator-(E&& vector) {
+    return {std::forward<E>(vector), -1};
+}
+
+template<typename L, typename R> requires (isMatrixExpression<L> && isMatrixExpression<R>)
+CMatrixBinary<CExpressionOperand<L>, CExpressionOperand<R>, std::plus<>> operator+(L&& left, R&& right) {
+    return {std::forward<L>(left), std::forward<R>(right)};
+}
+
+template<typename L, typename R> requires (isMatrixExpression<L> && isMatrixExpression<R>)
+CMatrixBinary<CExpressionOperand<L>, CExpressionOperand<R>, std::minus<>> operator-(L&& left, R&& right) {
+    return {std::forward<L>(left), std::forward<R>(right)};
+}
+
+template<typename E> requires isMatrixExpression<E>
+CMatrixScaled<CExpressionOperand<E>> operator*(E&& matrix, double factor) {
+    return {std::forward<E>(matrix), factor};
+}
+
+template<typename E> requires isMatrixExpression<E>
+CMatrixScaled<CExpressionOperand<E>> operator*(double factor, E&& matrix) {
+    return {std::forward<E>(matrix), factor};
+}
+
+template<typename E> requires isMatrixExpression<E>
+CMatrixScaled<CExpressionOperand<E>> operator-(E&& matrix) {
+    return {std::forward<E>(matrix), -1};
+}
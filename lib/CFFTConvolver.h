@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CComplex.h"
+#include <functional>
+#include <iostream>
+#include <span>
+#include <vector>
+
+/*
+ * Filters a signal block by block through its spectrum, so signals of any
+ * length run in memory proportional to the block size.
+ *
+ * With an impulse response the output is the exact linear convolution,
+ * computed by overlap-add or overlap-save. With a spectral filter every
+ * zero padded block is transformed (normalized like CComplex::fft), the
+ * filter edits the spectrum in place and the results are overlap-added.
+*/
+class CFFTConvolver {
+public:
+    enum class Method { OverlapAdd, OverlapSave };
+
+private:
+    int m_blockSize;
+    int m_fftSize;
+    int m_kernelSize;
+    Method m_method;
+    std::vector<CComplex> m_response;
+    std::function<void(std::span<CComplex>)> m_spectralFilter;
+    std::vector<CComplex> m_buffer;
+    std::vector<CComplex> m_overlap;
+
+    void filterBuffer();
+
+public:
+    CFFTConvolver(const std::vector<CComplex>& kernel, int blockSize, Method method = Method::OverlapAdd);
+    CFFTConvolver(std::function<void(std::span<CComplex>)> filter, int blockSize);
+
+    static CFFTConvolver threshold(double epsilon, int blockSize);
+
+    int blockSize() const;
+    std::vector<CComplex> process(std::span<const CComplex> block);
+    std::vector<CComplex> flush();
+    void reset();
+    // writes the first N samples of the filtered length N signal, see CFFTConvolver.cpp
+    void process(std::istream& in, std::ostream& out);
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CAlignedAllocator.h"
+#include "CComplex.h"
+#include <span>
+#include <vector>
+
+/*
+ * Precomputed tables for transforms of one size and direction.
+ * Plans are built once and cached process-wide, use get() to obtain one.
+ *
+ * Powers of two run an in-place radix-2 FFT, sizes made of the factors
+ * 2, 3 and 5 a mixed-radix FFT and all other sizes Bluestein's chirp-z
+ * algorithm on a power of two convolution.
+ *
+ * Power of two plans also run on split real/imaginary arrays, there the
+ * butterflies use AVX-512 or AVX2 when the CPU supports it.
+ *
+ * Large transforms split their butterflies and the mixed-radix sub-problems
+ * over CThreadPool, every value is still computed by the same operations.
+*/
+class CFFTPlan {
+private:
+    enum class Algorithm { Radix2, MixedRadix, Bluestein };
+
+    int m_size;
+    bool m_inverse;
+    Algorithm m_algorithm;
+    std::vector<CComplex> m_twiddles;
+    std::vector<int> m_bitReverse;
+    std::vector<double, CAlignedAllocator<double, 64>> m_stageRe;
+    std::vector<double, CAlignedAllocator<double, 64>> m_stageIm;
+    std::vector<int> m_factors;
+    std::vector<CComplex> m_chirp;
+    std::vector<CComplex> m_chirpSpectrum;
+
+    CFFTPlan(int size, bool inverse);
+    void radix2(std::span<CComplex> values) const;
+    void mixedRadix(CComplex* out, const CComplex* in, int stride, int stage) const;
+    void butterfly(CComplex* out, int stride, int p, int m, int from, int to) const;
+    void bluestein(std::span<CComplex> values) const;
+
+public:
+    static const CFFTPlan& get(int size, bool inverse = false);
+
+    int size() const;
+    bool inverse() const;
+    const CComplex& twiddle(int k) const;
+    void execute(std::span<CComplex> values) const;
+    void execute(double* re, double* im) const;
+    void executeBatch(double* re, double* im, int lanes) const;
+};
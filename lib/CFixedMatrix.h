@@ -0,0 +1,330 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include "CFixedVector.h"
+#include "CMyMatrix.h"
+
+/*
+ * R x C matrix with the interface of CMyMatrix whose dimensions are fixed
+ * at compile time, stored row-major in a std::array. Arithmetic, products,
+ * determinant(), solve() and inverse() are constexpr and allocate nothing.
+ *
+ * Square matrices are factored by Gaussian elimination with partial
+ * pivoting like CLUDecomposition. jacobi() and newton() are the
+ * counterparts of CMyMatrix::jacobi and CMyMatrix::newton for
+ * CFixedVector, with the Jacobian and every step on the stack.
+*/
+template<int R, int C>
+class CFixedMatrix {
+    static_assert(R > 0 && C > 0, "CFixedMatrix needs at least one row and column.");
+
+private:
+    std::array<double, R * C> m_data{};
+    static constexpr int NEWTON_MAX_STEPS = 50;
+    static constexpr double NEWTON_MAX_ERROR = 1e-5;
+    static constexpr bool DEBUG = false;
+
+    template<int, int>
+    friend class CFixedMatrix;
+
+    static constexpr double SINGULAR_TOLERANCE = 1e-13;
+
+    static constexpr double absolute(double value) { return value < 0 ? -value : value; }
+
+    /*
+     * P*A = L*U in place like CLUDecomposition, returns the sign of P.
+     * singular is set when a pivot is below SINGULAR_TOLERANCE times the
+     * largest entry.
+    */
+    constexpr int factor(std::array<int, R>& permutation, bool& singular) {
+        int sign = 1;
+        double scale = 0;
+        singular = false;
+
+        for (int i = 0; i < R; i++) {
+            permutation[i] = i;
+        }
+        for (double value : m_data) {
+            scale = absolute(value) > scale ? absolute(value) : scale;
+        }
+
+        for (int k = 0; k < R; k++) {
+            int pivotRow = k;
+            for (int i = k + 1; i < R; i++) {
+                if (absolute(m_data[i * C + k]) > absolute(m_data[pivotRow * C + k])) pivotRow = i;
+            }
+
+            if (pivotRow != k) {
+                for (int j = 0; j < C; j++) {
+                    std::swap(m_data[k * C + j], m_data[pivotRow * C + j]);
+                }
+                std::swap(permutation[k], permutation[pivotRow]);
+                sign = -sign;
+            }
+
+            double pivot = m_data[k * C + k];
+            if (!(absolute(pivot) > SINGULAR_TOLERANCE * scale)) {
+                singular = true;
+                if (pivot == 0) continue;
+            }
+
+            for (int i = k + 1; i < R; i++) {
+                double factor = m_data[i * C + k] / pivot;
+                m_data[i * C + k] = factor;
+                for (int j = k + 1; j < C; j++) {
+                    m_data[i * C + j] -= factor * m_data[k * C + j];
+                }
+            }
+        }
+
+        return sign;
+    }
+
+    template<typename F>
+    static CFixedMatrix jacobi(const CFixedVector<C>& x, const CFixedVector<R>& fx, const F& f, double h) {
+        CFixedMatrix result;
+
+        for (int j = 0; j < C; j++) {
+            CFixedVector<C> shifted = x;
+            shifted[j] += h;
+            CFixedVector<R> column = (f(shifted) - fx) * (1 / h);
+
+            for (int i = 0; i < R; i++) {
+                result.m_data[i * C + j] = column.get(i);
+            }
+        }
+
+        return result;
+    }
+
+public:
+    constexpr CFixedMatrix() = default;
+
+    constexpr CFixedMatrix(std::initializer_list<CFixedVector<C>> rows) {
+        if (rows.size() != R) {
+            throw std::invalid_argument("Number of rows must be the fixed row count.");
+        }
+
+        int i = 0;
+        for (const CFixedVector<C>& row : rows) {
+            for (int j = 0; j < C; j++) {
+                m_data[i * C + j] = row.get(j);
+            }
+            i++;
+        }
+    }
+
+    explicit CFixedMatrix(const CMyMatrix& matrix) {
+        if (matrix.rows() != R || matrix.columns() != C) {
+            throw std::invalid_argument("Dimensions must be the fixed dimensions.");
+        }
+
+        for (int i = 0; i < R * C; i++) {
+            m_data[i] = matrix.data()[i];
+        }
+    }
+
+    operator CMyMatrix() const {
+        CMyMatrix result(R, C);
+        for (int i = 0; i < R * C; i++) {
+            result.data()[i] = m_data[i];
+        }
+
+        return result;
+    }
+
+    static constexpr CFixedMatrix identity() requires (R == C) {
+        CFixedMatrix result;
+        for (int i = 0; i < R; i++) {
+            result.m_data[i * C + i] = 1;
+        }
+
+        return result;
+    }
+
+    constexpr std::tuple<int, int> dimensions() const { return std::make_tuple(R, C); }
+    constexpr int rows() const { return R; }
+    constexpr int columns() const { return C; }
+
+    constexpr double get(int row, int column) const {
+        if (row < 0 || row >= R || column < 0 || column >= C) {
+            throw std::invalid_argument("Index out of bounds.");
+        }
+
+        return m_data[row * C + column];
+    }
+
+    constexpr void set(int row, int column, double value) {
+        if (row < 0 || row >= R || column < 0 || column >= C) {
+            throw std::invalid_argument("Index out of bounds.");
+        }
+
+        m_data[row * C + column] = value;
+    }
+
+    constexpr CFixedMatrix operator+(const CFixedMatrix& other) const {
+        CFixedMatrix result;
+        for (int i = 0; i < R * C; i++) {
+            result.m_data[i] = m_data[i] + other.m_data[i];
+        }
+
+        return result;
+    }
+
+    constexpr CFixedMatrix operator-(const CFixedMatrix& other) const {
+        CFixedMatrix result;
+        for (int i = 0; i < R * C; i++) {
+            result.m_data[i] = m_data[i] - other.m_data[i];
+        }
+
+        return result;
+    }
+
+    constexpr CFixedMatrix operator-() const {
+        return *this * -1.0;
+    }
+
+    constexpr CFixedMatrix operator*(double scalar) const {
+        CFixedMatrix result;
+        for (int i = 0; i < R * C; i++) {
+            result.m_data[i] = m_data[i] * scalar;
+        }
+
+        return result;
+    }
+
+    constexpr CFixedVector<R> operator*(const CFixedVector<C>& vector) const {
+        CFixedVector<R> result;
+        for (int i = 0; i < R; i++) {
+            double sum = 0;
+            for (int j = 0; j < C; j++) {
+                sum += m_data[i * C + j] * vector.data()[j];
+            }
+            result[i] = sum;
+        }
+
+        return result;
+    }
+
+    template<int K>
+    constexpr CFixedMatrix<R, K> operator*(const CFixedMatrix<C, K>& other) const {
+        CFixedMatrix<R, K> result;
+        for (int i = 0; i < R; i++) {
+            for (int k = 0; k < C; k++) {
+                double a = m_data[i * C + k];
+                for (int j = 0; j < K; j++) {
+                    result.m_data[i * K + j] += a * other.m_data[k * K + j];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    constexpr CFixedMatrix<C, R> transpose() const {
+        CFixedMatrix<C, R> result;
+        for (int i = 0; i < R; i++) {
+            for (int j = 0; j < C; j++) {
+                result.m_data[j * R + i] = m_data[i * C + j];
+            }
+        }
+
+        return result;
+    }
+
+    constexpr double determinant() const requires (R == C) {
+        CFixedMatrix lu = *this;
+        std::array<int, R> permutation{};
+        bool singular = false;
+        double result = lu.factor(permutation, singular);
+
+        for (int i = 0; i < R; i++) {
+            result *= lu.m_data[i * C + i];
+        }
+
+        return result;
+    }
+
+    constexpr CFixedVector<R> solve(const CFixedVector<R>& b) const requires (R == C) {
+        CFixedMatrix lu = *this;
+        std::array<int, R> permutation{};
+        bool singular = false;
+        lu.factor(permutation, singular);
+        if (singular) {
+            throw std::invalid_argument("Matrix is singular.");
+        }
+
+        CFixedVector<R> x;
+        for (int i = 0; i < R; i++) {
+            double sum = b.get(permutation[i]);
+            for (int k = 0; k < i; k++) {
+                sum -= lu.m_data[i * C + k] * x.data()[k];
+            }
+            x[i] = sum;
+        }
+
+        for (int i = R - 1; i >= 0; i--) {
+            double sum = x.data()[i];
+            for (int k = i + 1; k < R; k++) {
+                sum -= lu.m_data[i * C + k] * x.data()[k];
+            }
+            x[i] = sum / lu.m_data[i * C + i];
+        }
+
+        return x;
+    }
+
+    constexpr CFixedMatrix inverse() const requires (R == C) {
+        CFixedMatrix result;
+        CFixedVector<R> unit;
+
+        for (int j = 0; j < R; j++) {
+            unit[j] = 1;
+            CFixedVector<R> column = solve(unit);
+            unit[j] = 0;
+
+            for (int i = 0; i < R; i++) {
+                result.m_data[i * C + j] = column.get(i);
+            }
+        }
+
+        return result;
+    }
+
+    std::string to_string(std::string title = "") const {
+        return CMyMatrix(*this).to_string(title);
+    }
+
+    // f is any callable CFixedVector<R>(const CFixedVector<C>&)
+    template<typename F>
+    static CFixedMatrix jacobi(const CFixedVector<C>& x, const F& f, double h = 1e-4) {
+        return jacobi(x, f(x), f, h);
+    }
+
+    template<typename F>
+    static CFixedVector<R> newton(const CFixedVector<R>& x, const F& f, double h = 1e-4) requires (R == C) {
+        CFixedVector<R> current = x;
+
+        for (int i = 0; i < NEWTON_MAX_STEPS; i++) {
+            CFixedVector<R> fx = f(current);
+            if (fx.magnitude() < NEWTON_MAX_ERROR) {
+                return current;
+            }
+
+            current -= jacobi(current, fx, f, h).solve(fx);
+        }
+
+        if (DEBUG) {
+            std::cout << "\nEnde wegen Schritt = " << NEWTON_MAX_STEPS << " bei x = " << current.to_string() << std::endl;
+        }
+
+        return current;
+    }
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "CMyVector.h"
+
+/*
+ * N-dimensional vector with the interface of CMyVector whose dimension is
+ * fixed at compile time. The values live in a std::array, so vectors are
+ * plain stack objects, everything except magnitude() is constexpr and
+ * the componentwise arithmetic is unrolled over the N components.
+ *
+ * CFixedVector(int) only accepts N, it exists so that templated solvers
+ * can create CMyVector and CFixedVector results the same way.
+*/
+template<int N>
+class CFixedVector {
+    static_assert(N > 0, "CFixedVector needs at least one component.");
+
+private:
+    std::array<double, N> m_data{};
+
+    template<typename Op, std::size_t... I>
+    static constexpr CFixedVector map(Op op, std::index_sequence<I...>) {
+        CFixedVector result;
+        ((result.m_data[I] = op(I)), ...);
+        return result;
+    }
+
+    template<typename Op>
+    static constexpr CFixedVector map(Op op) {
+        return map(op, std::make_index_sequence<N>());
+    }
+
+public:
+    constexpr CFixedVector() = default;
+
+    explicit constexpr CFixedVector(int dimension) {
+        if (dimension != N) {
+            throw std::invalid_argument("Dimension must be the fixed dimension.");
+        }
+    }
+
+    constexpr CFixedVector(std::initializer_list<double> values) {
+        if (values.size() != N) {
+            throw std::invalid_argument("Number of values must be the fixed dimension.");
+        }
+
+        int i = 0;
+        for (double value : values) {
+            m_data[i++] = value;
+        }
+    }
+
+    explicit CFixedVector(const CMyVector& vector) {
+        if (vector.dimension() != N) {
+            throw std::invalid_argument("Dimension must be the fixed dimension.");
+        }
+
+        for (int i = 0; i < N; i++) {
+            m_data[i] = vector.get(i);
+        }
+    }
+
+    operator CMyVector() const {
+        return CMyVector(std::vector<double>(m_data.begin(), m_data.end()));
+    }
+
+    constexpr int dimension() const { return N; }
+    constexpr const double* data() const { return m_data.data(); }
+
+    constexpr double& operator[](int index) {
+        if (index < 0 || index >= N) {
+            throw std::out_of_range("Index out of range.");
+        }
+
+        return m_data[index];
+    }
+
+    constexpr double get(int index) const {
+        if (index < 0 || index >= N) {
+            throw std::out_of_range("Index out of range.");
+        }
+
+        return m_data[index];
+    }
+
+    constexpr CFixedVector operator+(const CFixedVector& other) const {
+        return map([&](std::size_t i) { return m_data[i] + other.m_data[i]; });
+    }
+
+    constexpr CFixedVector operator-(const CFixedVector& other) const {
+        return map([&](std::size_t i) { return m_data[i] - other.m_data[i]; });
+    }
+
+    constexpr CFixedVector operator-() const {
+        return map([&](std::size_t i) { return -m_data[i]; });
+    }
+
+    constexpr CFixedVector operator*(double scalar) const {
+        return map([&](std::size_t i) { return m_data[i] * scalar; });
+    }
+
+    friend constexpr CFixedVector operator*(double scalar, const CFixedVector& vector) {
+        return vector * scalar;
+    }
+
+    // componentwise product like CMyVector
+    constexpr CFixedVector operator*(const CFixedVector& other) const {
+        return map([&](std::size_t i) { return m_data[i] * other.m_data[i]; });
+    }
+
+    constexpr CFixedVector& operator+=(const CFixedVector& other) { return *this = *this + other; }
+    constexpr CFixedVector& operator-=(const CFixedVector& other) { return *this = *this - other; }
+    constexpr CFixedVector& operator*=(double scalar) { return *this = *this * scalar; }
+
+    constexpr bool operator==(const CFixedVector& other) const { return m_data == other.m_data; }
+    constexpr bool operator!=(const CFixedVector& other) const { return !(*this == other); }
+
+    constexpr double dot(const CFixedVector& other) const {
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return (... + (m_data[I] * other.m_data[I]));
+        }(std::make_index_sequence<N>());
+    }
+
+    double magnitude() const { return std::sqrt(dot(*this)); }
+
+    CFixedVector normalize() const {
+        double mag = magnitude();
+
+        if (std::abs(mag) < 1e-12) {
+            return CFixedVector();
+        }
+
+        return *this * (1 / mag);
+    }
+
+    std::string to_string() const {
+        std::string result = "(";
+        for (int i = 0; i < N; i++) {
+            result += std::to_string(m_data[i]);
+            if (i < N - 1) {
+                result += ", ";
+            }
+        }
+        result += ")";
+
+        return result;
+    }
+};
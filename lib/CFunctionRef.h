@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature>
+class CFunctionRef;
+
+/*
+ * Non-owning reference to any callable with the given signature, the
+ * counterpart of std::function for parameters: constructing it stores a
+ * pointer to the callable and a pointer to a function calling it, without
+ * allocating or copying the callable.
+ *
+ * The callable must outlive the reference. That is always the case for
+ * a parameter, because a temporary argument lives until the call returns.
+ * A CFunctionRef variable must therefore not be initialized from a
+ * temporary lambda.
+*/
+template<typename R, typename... Args>
+class CFunctionRef<R(Args...)> {
+private:
+    void* m_callable;
+    R (*m_call)(void*, Args...);
+
+public:
+    template<typename F>
+        requires (!std::is_same_v<std::remove_cvref_t<F>, CFunctionRef> && std::is_invocable_r_v<R, F&, Args...>)
+    CFunctionRef(F&& f) noexcept {
+        using Callable = std::remove_reference_t<F>;
+
+        if constexpr (std::is_function_v<Callable>) {
+            m_callable = reinterpret_cast<void*>(&f);
+        } else {
+            m_callable = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+        }
+
+        m_call = [](void* callable, Args... args) -> R {
+            if constexpr (std::is_function_v<Callable>) {
+                return std::invoke(reinterpret_cast<Callable*>(callable), std::forward<Args>(args)...);
+            } else {
+                return std::invoke(*static_cast<Callable*>(callable), std::forward<Args>(args)...);
+            }
+        };
+    }
+
+    R operator()(Args... args) const {
+        return m_call(m_callable, std::forward<Args>(args)...);
+    }
+};
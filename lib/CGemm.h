@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CMatrixView.h"
+
+/*
+ * Matrix product C = A * B for CMyMatrix and matrix views.
+ *
+ * Blocks of B (KC x NC) and A (MC x KC) are packed into contiguous
+ * panels that stay in L2/L1, a register-tiled 6x8 micro-kernel then
+ * computes C tile by tile. The micro-kernel uses AVX2 FMA when the CPU
+ * supports it and a scalar loop otherwise. Row blocks of C are spread
+ * over CThreadPool.
+ *
+ * A and B may be any strided views (e.g. transposes), c is a row-major
+ * buffer with row length ldc that is overwritten.
+*/
+class CGemm {
+public:
+    static void multiply(const CMatrixView& a, const CMatrixView& b, double* c, int ldc);
+    static bool usesSimd();
+};
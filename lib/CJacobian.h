@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CComplex.h"
+#include "CFunctionRef.h"
+#include "CMyMatrix.h"
+#include "CMyVector.h"
+#include <vector>
+
+/*
+ * Finite difference Jacobians of f: R^n -> R^m, column j from evaluations
+ * of f at x perturbed in coordinate j only.
+ *
+ * Forward differences cost n + 1 evaluations of f (n if f(x) is already
+ * known), central differences 2n with error O(h^2). The complex step
+ * derivative Im f(x + i*h*e_j) / h needs f on complex arguments but has
+ * no cancellation, so h can be tiny and the result is exact to rounding.
+ *
+ * f is taken as a CFunctionRef, so any callable can be passed without
+ * wrapping it in a std::function. With parallel = true the columns are
+ * spread over CThreadPool, f must then be safe to call from several
+ * threads.
+*/
+class CJacobian {
+public:
+    enum class Difference { Forward, Central };
+
+    using Function = CFunctionRef<CMyVector(const CMyVector&)>;
+    using ComplexFunction = CFunctionRef<std::vector<CComplex>(const std::vector<CComplex>&)>;
+
+    static CMyMatrix compute(const CMyVector& x, Function f, double h = 1e-4, Difference difference = Difference::Forward, bool parallel = false);
+    static CMyMatrix forward(const CMyVector& x, const CMyVector& fx, Function f, double h = 1e-4, bool parallel = false);
+    static CMyMatrix complexStep(const std::vector<double>& x, ComplexFunction f, double h = 1e-20, bool parallel = false);
+};
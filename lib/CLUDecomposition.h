@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+class CMyMatrix;
+class CMyVector;
+
+/*
+ * LU factorization P*A = L*U of a square matrix with partial pivoting,
+ * computed once in O(n^3) and reused for any number of right-hand sides.
+ *
+ * L (unit diagonal) and U share one row-major n*n buffer, the row
+ * permutation is kept as the original row index of every row.
+ * A pivot that is zero relative to the largest entry of A marks the
+ * matrix as singular: determinant() still works, solve() and
+ * inverse() throw.
+*/
+class CLUDecomposition {
+private:
+    int m_size;
+    std::vector<double> m_lu;
+    std::vector<int> m_permutation;
+    int m_sign;
+    bool m_singular;
+    static const double SINGULAR_TOLERANCE;
+
+    void checkSolvable(int rows) const;
+
+public:
+    CLUDecomposition(const CMyMatrix& matrix);
+    int size() const;
+    bool singular() const;
+    double determinant() const;
+    CMyVector solve(const CMyVector& b) const;
+    CMyMatrix solve(const CMyMatrix& b) const;
+    CMyMatrix inverse() const;
+};
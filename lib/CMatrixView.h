@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdexcept>
+#include <tuple>
+#include "CExpression.h"
+
+/*
+ * Read-only strided view on doubles owned by someone else, e.g. a row or
+ * column of a CMyMatrix. Element i is data[i * stride].
+ *
+ * Views do not copy, they must not outlive the matrix they look at.
+ * Converting one to CMyVector makes the copy. Views are operands of the
+ * vector and matrix expressions like CMyVector and CMyMatrix.
+*/
+class CVectorView : public CVectorExpression<CVectorView> {
+private:
+    const double* m_data;
+    int m_dimension;
+    int m_stride;
+
+public:
+    static constexpr bool BY_REFERENCE = false;
+
+    CVectorView(const double* data, int dimension, int stride = 1)
+        : m_data(data), m_dimension(dimension), m_stride(stride) {}
+
+    int dimension() const { return m_dimension; }
+    int stride() const { return m_stride; }
+    const double* data() const { return m_data; }
+
+    double operator[](int index) const { return m_data[(long long)index * m_stride]; }
+    double element(int index) const { return (*this)[index]; }
+
+    double get(int index) const {
+        if (index < 0 || index >= m_dimension) {
+            throw std::out_of_range("Index out of range.");
+        }
+
+        return (*this)[index];
+    }
+};
+
+/*
+ * Read-only strided view on a matrix, element (i, j) is
+ * data[i * rowStride + j * columnStride]. Rows, columns, submatrices and
+ * the transpose of a view are views again.
+*/
+class CMatrixView : public CMatrixExpression<CMatrixView> {
+private:
+    const double* m_data;
+    int m_rows;
+    int m_columns;
+    int m_rowStride;
+    int m_columnStride;
+
+public:
+    static constexpr bool BY_REFERENCE = false;
+
+    CMatrixView(const double* data, int rows, int columns, int rowStride, int columnStride = 1)
+        : m_data(data), m_rows(rows), m_columns(columns), m_rowStride(rowStride), m_columnStride(columnStride) {}
+
+    std::tuple<int, int> dimensions() const { return std::make_tuple(m_rows, m_columns); }
+    int rows() const { return m_rows; }
+    int columns() const { return m_columns; }
+    int rowStride() const { return m_rowStride; }
+    int columnStride() const { return m_columnStride; }
+    const double* data() const { return m_data; }
+
+    double operator()(int row, int column) const {
+        return m_data[(long long)row * m_rowStride + (long long)column * m_columnStride];
+    }
+
+    double element(int row, int column) const { return (*this)(row, column); }
+
+    double get(int row, int column) const {
+        if (row < 0 || row >= m_rows || column < 0 || column >= m_columns) {
+            throw std::invalid_argument("Index out of bounds.");
+        }
+
+        return (*this)(row, column);
+    }
+
+    CVectorView row(int index) const {
+        if (index < 0 || index >= m_rows) throw std::out_of_range("Row index out of range.");
+        return CVectorView(m_data + (long long)index * m_rowStride, m_columns, m_columnStride);
+    }
+
+    CVectorView column(int index) const {
+        if (index < 0 || index >= m_columns) throw std::out_of_range("Column index out of range.");
+        return CVectorView(m_data + (long long)index * m_columnStride, m_rows, m_rowStride);
+    }
+
+    CMatrixView submatrix(int row, int column, int rows, int columns) const {
+        if (row < 0 || column < 0 || rows < 0 || columns < 0 || row + rows > m_rows || column + columns > m_columns) {
+            throw std::out_of_range("Submatrix exceeds the matrix.");
+        }
+
+        return CMatrixView(m_data + (long long)row * m_rowStride + (long long)column * m_columnStride,
+                           rows, columns, m_rowStride, m_columnStride);
+    }
+
+    CMatrixView transpose() const {
+        return CMatrixView(m_data, m_columns, m_rows, m_columnStride, m_rowStride);
+    }
+};
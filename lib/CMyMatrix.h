@@ -3,36 +3,83 @@
 #include <initializer_list>
 #include <vector>
 #include <string>
+#include "CAlignedAllocator.h"
+#include "CLUDecomposition.h"
+#include "CMatrixView.h"
 #include "CMyVector.h"
 
 /*
- * Stores n*m-dimensional matrices.
+ * Stores n*m-dimensional matrices in one aligned row-major buffer.
+ * row(), column(), submatrix() and transpose() return views into that
+ * buffer instead of copies. Called on a temporary matrix they return
+ * copies, since a view would outlive the buffer. +, - and scalar products are expression
+ * templates (see CExpression.h), products with vectors and matrices are
+ * computed right away.
+ *
+ * determinant() and inverse() go through an LU factorization, lu()
+ * returns it for solving several systems with the same matrix. newton()
+ * runs CNewtonSolver with full Newton steps.
 */
-class CMyMatrix {
+class CMyMatrix : public CMatrixExpression<CMyMatrix> {
 private:
-    std::vector<std::vector<double>> m_data;
+    int m_rows;
+    int m_columns;
+    std::vector<double, CAlignedAllocator<double, 64>> m_data;
     static const int NEWTON_MAX_STEPS;
     static const double NEWTON_MAX_ERROR;
     static const bool DEBUG;
 public:
+    static constexpr bool BY_REFERENCE = true;
+
     CMyMatrix(int rows, int columns);
     CMyMatrix(std::initializer_list<CMyVector> values);
+
+    template<typename E>
+    CMyMatrix(const CMatrixExpression<E>& expression) : CMyMatrix(expression.rows(), expression.columns()) {
+        double* out = m_data.data();
+        for (int i = 0; i < m_rows; i++) {
+            for (int j = 0; j < m_columns; j++) {
+                out[(long long)i * m_columns + j] = expression.element(i, j);
+            }
+        }
+    }
+
+    CMyMatrix(const CMyMatrix& other) = default;
+    CMyMatrix(CMyMatrix&& other) = default;
+    CMyMatrix& operator=(const CMyMatrix& other) = default;
+    CMyMatrix& operator=(CMyMatrix&& other) = default;
+
+    // evaluated into a new buffer, A = A.transpose() + B reads A while it is written otherwise
+    template<typename E>
+    CMyMatrix& operator=(const CMatrixExpression<E>& expression) {
+        return *this = CMyMatrix(expression);
+    }
+
     ~CMyMatrix();
     std::tuple<int, int> dimensions() const;
+    int rows() const { return m_rows; }
+    int columns() const { return m_columns; }
+    double element(int row, int column) const { return m_data[(long long)row * m_columns + column]; }
     double get(int row, int column) const;
-    CMyVector row(int index) const;
-    CMyVector column(int index) const;
+    double* data();
+    const double* data() const;
+    CMatrixView view() const&;
+    CMatrixView view() && = delete;
+    CVectorView row(int index) const&;
+    CMyVector row(int index) &&;
+    CVectorView column(int index) const&;
+    CMyVector column(int index) &&;
+    CMatrixView submatrix(int row, int column, int rows, int columns) const&;
+    CMyMatrix submatrix(int row, int column, int rows, int columns) &&;
     void set(int row, int column, double value);
-    CMyMatrix operator+(const CMyMatrix& other) const;
-    CMyMatrix operator-(const CMyMatrix& other) const;
-    CMyMatrix operator-() const;
-    CMyMatrix operator*(const double scalar) const;
     CMyVector operator*(const CMyVector& other) const;
     CMyMatrix operator*(const CMyMatrix& other) const;
-    CMyMatrix transpose() const;
+    CMatrixView transpose() const&;
+    CMyMatrix transpose() &&;
+    CLUDecomposition lu() const;
     double determinant() const;
     CMyMatrix inverse() const;
     std::string to_string(std::string title = "") const;
-    static CMyMatrix jacobi(const CMyVector& x, std::function<CMyVector(CMyVector)> f, double h = 1e-4);
-    static CMyVector newton(const CMyVector& x, std::function<CMyVector(CMyVector)> f, double h = 1e-4);
+    static CMyMatrix jacobi(const CMyVector& x, CFunctionRef<CMyVector(const CMyVector&)> f, double h = 1e-4);
+    static CMyVector newton(const CMyVector& x, CFunctionRef<CMyVector(const CMyVector&)> f, double h = 1e-4);
 };
@@ -1,40 +1,232 @@
-#include <initializer_list>
 #pragma once
 
+#include <initializer_list>
 #include <vector>
 #include <string>
 #include <functional>
+#include <iostream>
+#include <type_traits>
+#include "CExpression.h"
+#include "CFunctionRef.h"
+#include "HelperOutput.h"
 
 /**
- * Stores n-dimensional vectors.
+ * Stores n-dimensional vectors. Arithmetic builds expression templates
+ * (see CExpression.h) that are evaluated when assigned to a CMyVector.
 **/
-class CMyVector {
+class CMyVector : public CVectorExpression<CMyVector> {
 private:
     std::vector<double> m_data;
     static const int MAX_STEPS;
     static const double MAX_ERROR;
     static const bool DEBUG;
+
+    template<typename V, typename F>
+    static V gradient(const V& x, double fx, const F& f, double h);
 public:
-    CMyVector(int dimension);
+    static constexpr bool BY_REFERENCE = true;
+
+    explicit CMyVector(int dimension);
     CMyVector(std::initializer_list<double> values);
     CMyVector(std::vector<double> values);
+
+    template<typename E>
+    CMyVector(const CVectorExpression<E>& expression) : m_data(expression.dimension()) {
+        for (int i = 0; i < m_data.size(); i++) {
+            m_data[i] = expression.element(i);
+        }
+    }
+
+    CMyVector(const CMyVector& other) = default;
+    CMyVector(CMyVector&& other) = default;
+    CMyVector& operator=(const CMyVector& other) = default;
+    CMyVector& operator=(CMyVector&& other) = default;
+
+    // all operations are componentwise, so y = y + d * h may overwrite y in place
+    template<typename E>
+    CMyVector& operator=(const CVectorExpression<E>& expression) {
+        m_data.resize(expression.dimension());
+        for (int i = 0; i < m_data.size(); i++) {
+            m_data[i] = expression.element(i);
+        }
+
+        return *this;
+    }
+
+    template<typename E>
+    CMyVector& operator+=(const CVectorExpression<E>& expression) {
+        if (dimension() != expression.dimension()) {
+            throw std::invalid_argument("Vectors must have the same dimension.");
+        }
+
+        for (int i = 0; i < m_data.size(); i++) {
+            m_data[i] += expression.element(i);
+        }
+
+        return *this;
+    }
+
+    template<typename E>
+    CMyVector& operator-=(const CVectorExpression<E>& expression) {
+        if (dimension() != expression.dimension()) {
+            throw std::invalid_argument("Vectors must have the same dimension.");
+        }
+
+        for (int i = 0; i < m_data.size(); i++) {
+            m_data[i] -= expression.element(i);
+        }
+
+        return *this;
+    }
+
+    CMyVector& operator*=(double scalar);
+
     ~CMyVector();
     int dimension() const;
+    double element(int index) const { return m_data[index]; }
     double& operator[](int index);
     double get(int index) const;
-    CMyVector operator+(const CMyVector& other) const;
-    CMyVector operator-(const CMyVector& other) const;
-    CMyVector operator-() const;
-    CMyVector operator*(double scalar) const;
-    CMyVector operator*(const CMyVector& other) const;
     bool operator==(const CMyVector& other) const;
     bool operator!=(const CMyVector& other) const;
     double magnitude() const;
     CMyVector normalize() const;
-    static CMyVector gradient(const CMyVector& x, std::function<double(CMyVector)> f, double h = 1e-10);
-    static CMyVector minimize(const CMyVector& x, std::function<double(CMyVector)> f, double lambda = 1.0, double h = 1e-10);
-    static CMyVector maximize(const CMyVector& x, std::function<double(CMyVector)> f, double lambda = 1.0, double h = 1e-10);
+
+    /*
+     * V is CMyVector or CFixedVector<N>, f is any callable double(const V&)
+     * taken by reference, so it can be inlined. The overloads taking a
+     * CFunctionRef are compiled once for callers that pass one explicitly.
+    */
+    template<typename V, typename F>
+    static V gradient(const V& x, const F& f, double h = 1e-10);
+    template<typename V, typename F>
+    static V minimize(const V& x, const F& f, double lambda = 1.0, double h = 1e-10);
+    template<typename V, typename F>
+    static V maximize(const V& x, const F& f, double lambda = 1.0, double h = 1e-10);
+    static CMyVector gradient(const CMyVector& x, CFunctionRef<double(const CMyVector&)> f, double h = 1e-10);
+    static CMyVector minimize(const CMyVector& x, CFunctionRef<double(const CMyVector&)> f, double lambda = 1.0, double h = 1e-10);
+    static CMyVector maximize(const CMyVector& x, CFunctionRef<double(const CMyVector&)> f, double lambda = 1.0, double h = 1e-10);
+
     static std::function<double(double)> polynomial(CMyVector coefficients);
     static CMyVector curveFit(std::vector<CMyVector> points, int degree);
     std::string to_string() const;
 };
+
+template<typename V, typename F>
+V CMyVector::gradient(const V& x, const F& f, double h) {
+    return gradient(x, f(x), f, h);
+}
+
+// forward differences around x, where fx = f(x) is already known
+template<typename V, typename F>
+V CMyVector::gradient(const V& x, double fx, const F& f, double h) {
+    static_assert(std::is_arithmetic_v<std::remove_cvref_t<std::invoke_result_t<const F&, const V&>>>, "f must return a number.");
+
+    V result(x.dimension());
+    V shifted(x);
+
+    for (int i = 0; i < x.dimension(); i++) {
+        shifted[i] = x.get(i) + h;
+        result[i] = (f(shifted) - fx) / h;
+        shifted[i] = x.get(i);
+    }
+
+    return result;
+}
+
+template<typename V, typename F>
+V CMyVector::minimize(const V& x, const F& f, double lambda, double h) {
+    return CMyVector::maximize(x, [&f](const V& v) { return -f(v); }, lambda, h);
+}
+
+/*
+ * Gradient ascent with step size control. Every point is evaluated once,
+ * the step output is only formatted when DEBUG is set.
+*/
+template<typename V, typename F>
+V CMyVector::maximize(const V& x, const F& f, double lambda, double h) {
+    static_assert(std::is_arithmetic_v<std::remove_cvref_t<std::invoke_result_t<const F&, const V&>>>, "f must return a number.");
+
+    Helper::OutputMute mute(!DEBUG);
+
+    V current_pos = x;
+    double step_size = lambda;
+    int step = 0;
+
+    while(true){
+        double f_current = f(current_pos);
+        V gradient = CMyVector::gradient(current_pos, f_current, f, h);
+        V new_pos = current_pos + (gradient * step_size);
+        
+        if(gradient.magnitude() < MAX_ERROR || step >= MAX_STEPS) {
+            std::cout << std::endl;
+            if(gradient.magnitude() < MAX_ERROR)
+                std::cout << "Ende wegen ||grad f(x)|| < " << MAX_ERROR << " bei" << std::endl;
+            else
+                std::cout << "Ende wegen Schrittanzahl = " << MAX_STEPS << " bei" << std::endl;
+            std::cout << "\tx = " << current_pos.to_string() << std::endl;
+            std::cout << "\tlambda = " << step_size << std::endl;
+            std::cout << "\tf(x) = " << f_current << std::endl;
+            std::cout << "\tgrad f(x) = " << gradient.to_string() << std::endl;
+            std::cout << "\t||grad f(x)|| = " << gradient.magnitude() << std::endl;
+            return current_pos;
+        }
+
+        double f_new = f(new_pos);
+
+        if (DEBUG) {
+            std::cout << std::endl;
+            std::cout << "Schritt " << step << ":" << std::endl;
+            std::cout << "\tx = " << current_pos.to_string() << std::endl;
+            std::cout << "\tlambda = " << step_size << std::endl;
+
+            std::cout << "\tf(x) = " << f_current << std::endl;
+            std::cout << "\tgrad f(x) = " << gradient.to_string() << std::endl;
+            std::cout << "\t||grad f(x)|| = " << gradient.magnitude() << std::endl;
+            
+            std::cout << std::endl;
+            
+            std::cout << "\tx_neu = " << new_pos.to_string() << std::endl;
+            std::cout << "\tf(x_neu) = " << f_new << std::endl;
+        }
+
+        if(f_new > f_current) {
+            double test_step_size = step_size * 2.0;
+            V test_new_pos = current_pos + (gradient * test_step_size);
+            double f_test = f(test_new_pos);
+
+            if (DEBUG) {
+                std::cout << std::endl;
+                std::cout << "\tTest mit doppelter Schrittweite (lambda = " << test_step_size << ")" << std::endl;
+                std::cout << "\tx_test = " << test_new_pos.to_string() << std::endl;
+                std::cout << "\tf(x_test) = " << f_test << std::endl;
+            }
+
+            if(f_test > f_new) {
+                if (DEBUG) std::cout << "\tverdopple Schrittweite" << std::endl;
+                current_pos = test_new_pos;
+                step_size = test_step_size;
+            }else{
+                if (DEBUG) std::cout << "\tbehalte alte Schrittweite!" << std::endl;
+                current_pos = new_pos;
+            }
+        } else {
+            while(f_new < f_current) {
+                step_size /= 2.0;
+                
+                new_pos = current_pos + (gradient * step_size);
+                f_new = f(new_pos);
+
+                if (DEBUG) {
+                    std::cout << std::endl;
+                    std::cout << "\thalbiere Schrittweite (lambda = " << step_size << "):" << std::endl;
+                    std::cout << "\tx_neu = " << new_pos.to_string() << std::endl;
+                    std::cout << "\tf(x_neu) = " << f_new << std::endl;
+                }
+            }
+
+            current_pos = new_pos;
+        }
+
+        step++;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CMyMatrix.h"
+#include "CMyVector.h"
+#include <functional>
+
+/*
+ * Solves f(x) = 0 for f: R^n -> R^n.
+ *
+ * Newton computes and factors the Jacobian in every step. Shamanskii
+ * keeps the factored Jacobian for reuse() steps (a large reuse() is the
+ * chord method). Broyden factors one Jacobian and afterwards only applies
+ * rank-one updates of its inverse, which costs one evaluation of f per
+ * step. Shamanskii and Broyden start over with a fresh Jacobian as soon
+ * as a step reduces ||f(x)|| by less than STALL_RATIO.
+ *
+ * The linear solver turns a Jacobian into a function solving J * dx = b,
+ * the default factors it with CMyMatrix::lu(). Without an analytic
+ * Jacobian it is approximated by forward differences with step h, which
+ * reuse f(x) and cost n evaluations.
+*/
+class CNewtonSolver {
+public:
+    enum class Method { Newton, Shamanskii, Broyden };
+
+    using Factorization = std::function<CMyVector(const CMyVector&)>;
+    using LinearSolver = std::function<Factorization(const CMyMatrix&)>;
+
+    struct Result {
+        CMyVector x;
+        bool converged;
+        int iterations;
+        int evaluations;
+        int jacobians;
+        double residual;
+    };
+
+private:
+    std::function<CMyVector(const CMyVector&)> m_f;
+    std::function<CMyMatrix(const CMyVector&)> m_jacobian;
+    LinearSolver m_linearSolver;
+    Method m_method;
+    int m_reuse;
+    double m_h;
+    double m_tolerance;
+    int m_maxSteps;
+    static const double STALL_RATIO;
+    static const int MAX_BROYDEN_UPDATES;
+
+public:
+    CNewtonSolver(std::function<CMyVector(const CMyVector&)> f, Method method = Method::Newton, int reuse = 1, double h = 1e-4);
+
+    static LinearSolver lu();
+
+    void setJacobian(std::function<CMyMatrix(const CMyVector&)> jacobian);
+    void setLinearSolver(LinearSolver linearSolver);
+    void setTolerance(double tolerance, int maxSteps);
+
+    Method method() const;
+    int reuse() const;
+
+    Result solve(const CMyVector& x) const;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CComplex.h"
+#include <vector>
+
+/*
+ * Short-time Fourier transform: the signal is cut into frames of size()
+ * samples that start every hop() samples, every frame is weighted with the
+ * window and transformed like CComplex::fft.
+ *
+ * Hann and Hamming are the periodic variants (period size()), so their
+ * spectra are three-term kernels and CSlidingDFT can apply them per bin.
+*/
+class CSTFT {
+public:
+    enum class Window { Rectangular, Hann, Hamming };
+
+private:
+    int m_size;
+    int m_hop;
+    Window m_window;
+    std::vector<double> m_weights;
+
+public:
+    CSTFT(int size, int hop, Window window = Window::Hann);
+
+    static std::vector<double> weights(Window window, int size);
+
+    int size() const;
+    int hop() const;
+    Window window() const;
+    int frameCount(int length) const;
+
+    std::vector<CComplex> frame(const std::vector<CComplex>& values, int start) const;
+    std::vector<std::vector<CComplex>> spectrogram(const std::vector<CComplex>& values) const;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CComplex.h"
+#include "CSTFT.h"
+#include <span>
+#include <vector>
+
+/*
+ * DFT over the last size() samples of a stream, updated per sample instead
+ * of being recomputed. A new sample moves every bin by
+ *
+ *   X_k <- (X_k - x_old + x_new) * e^(2 pi i k / N)
+ *
+ * so push() costs O(N) and bin() O(1). The window is applied in the
+ * frequency domain (Hann: -1/4, 1/2, -1/4 of the neighbouring bins), the
+ * results match CSTFT::frame() on the same samples.
+ *
+ * The rotations accumulate rounding errors, so the bins are recomputed
+ * from the stored samples with one FFT after every few windows.
+*/
+class CSlidingDFT {
+private:
+    int m_size;
+    CSTFT::Window m_window;
+    std::vector<CComplex> m_rotation;
+    std::vector<CComplex> m_history;
+    std::vector<CComplex> m_bins;
+    int m_position;
+    int m_sinceResync;
+
+    void resync();
+
+public:
+    CSlidingDFT(int size, CSTFT::Window window = CSTFT::Window::Rectangular);
+
+    int size() const;
+    void push(const CComplex& sample);
+    void push(std::span<const CComplex> samples);
+    CComplex bin(int k) const;
+    std::vector<CComplex> spectrum() const;
+    void reset();
+};
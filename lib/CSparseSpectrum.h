@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CComplex.h"
+#include <vector>
+
+/*
+ * Spectrum of length size() that stores only its nonzero coefficients as
+ * (index, value) pairs, e.g. a spectrum written with a threshold by
+ * Helper::writeValues.
+ *
+ * idft() evaluates the inverse transform over the stored coefficients only
+ * in O(K * N), inverse() uses it when that is cheaper than an FFT of the
+ * zero padded spectrum. Both are normalized like CComplex::idft.
+*/
+class CSparseSpectrum {
+private:
+    int m_size;
+    std::vector<int> m_indices;
+    std::vector<CComplex> m_values;
+
+public:
+    CSparseSpectrum(int size);
+    CSparseSpectrum(const std::vector<CComplex>& values, double epsilon = 0);
+
+    int size() const;
+    int nonZeros() const;
+    double density() const;
+    int index(int i) const;
+    const CComplex& value(int i) const;
+
+    void add(int index, const CComplex& value);
+    std::vector<CComplex> toDense() const;
+
+    static int directLimit(int size);
+    bool prefersDirect() const;
+    std::vector<CComplex> idft() const;
+    std::vector<CComplex> inverse() const;
+};
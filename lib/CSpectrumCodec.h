@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CComplex.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+ * Lossy compressed storage for spectra. Like Helper::writeValues only
+ * coefficients with |c| > epsilon are kept. Their indices are stored as
+ * gaps to the previous index, re and im are rounded to multiples of step.
+ * Gaps and values become zigzag varint bytes, and each of the three byte
+ * streams is entropy coded with a static order-0 rANS coder (raw when
+ * that is smaller).
+ *
+ * Every coefficient is reconstructed within step / 2 per component.
+*/
+class CSpectrumCodec {
+public:
+    struct Report {
+        int nonZeros;
+        std::size_t textBytes;
+        std::size_t compressedBytes;
+        double ratio;
+        double maxDeviation;
+    };
+
+private:
+    double m_epsilon;
+    double m_step;
+
+public:
+    CSpectrumCodec(double epsilon = -1, double step = 1e-6);
+
+    double epsilon() const;
+    double step() const;
+
+    std::vector<std::uint8_t> encode(const std::vector<CComplex>& spectrum) const;
+    static std::vector<CComplex> decode(const std::vector<std::uint8_t>& data);
+
+    void write(const std::string& filename, const std::vector<CComplex>& spectrum) const;
+    static std::vector<CComplex> read(const std::string& filename);
+
+    Report report(const std::vector<CComplex>& signal, const std::vector<CComplex>& spectrum,
+                  const std::function<std::vector<CComplex>(const std::vector<CComplex>&)>& inverse) const;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CComplex.h"
+#include "CSparseSpectrum.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/*
+ * Binary container for spectra, replacing the text files for large data.
+ *
+ * A 48 byte header (magic "CSPF", version, kind, N, entry count, threshold
+ * and a checksum of the payload) is followed either by N dense values as
+ * re/im doubles or by count sparse entries of (int64 index, re, im).
+ * All fields are little endian.
+ *
+ * Opening a file maps it into memory, dense() and entries() are views
+ * into the mapping and stay valid as long as the CSpectrumFile lives.
+*/
+class CSpectrumFile {
+public:
+    enum class Kind : std::uint16_t { Dense = 0, Sparse = 1 };
+
+    struct Entry {
+        std::int64_t index;
+        CComplex value;
+    };
+
+    static const std::uint16_t VERSION = 1;
+
+private:
+    struct Header {
+        char magic[4];
+        std::uint16_t version;
+        Kind kind;
+        std::int64_t size;
+        std::int64_t count;
+        double threshold;
+        std::uint64_t checksum;
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(Header) == 48);
+
+    void* m_data;
+    std::size_t m_length;
+    const Header* m_header;
+
+    const std::byte* payload() const;
+    static std::uint64_t checksum(const std::byte* data, std::size_t length);
+    static void write(const std::string& filename, Kind kind, std::int64_t size, double threshold, const void* payload, std::size_t count, std::size_t entrySize);
+
+public:
+    CSpectrumFile(const std::string& filename, bool verify = true);
+    CSpectrumFile(const CSpectrumFile&) = delete;
+    CSpectrumFile& operator=(const CSpectrumFile&) = delete;
+    ~CSpectrumFile();
+
+    Kind kind() const;
+    int size() const;
+    int count() const;
+    double threshold() const;
+
+    std::span<const CComplex> dense() const;
+    std::span<const Entry> entries() const;
+    std::vector<CComplex> toVector() const;
+    CSparseSpectrum toSparse() const;
+
+    static void writeDense(const std::string& filename, std::span<const CComplex> values, double threshold = -1);
+    static void writeSparse(const std::string& filename, const CSparseSpectrum& spectrum, double threshold = -1);
+    static void write(const std::string& filename, const std::vector<CComplex>& values, double epsilon = -1);
+    static void convertText(const std::string& textFile, const std::string& binaryFile, double threshold = -1);
+};
+
+static_assert(std::endian::native == std::endian::little);
+static_assert(sizeof(CSpectrumFile::Entry) == 24);
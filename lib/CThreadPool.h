@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Work-stealing thread pool shared by the numerics code. Every worker owns
+ * a task queue, takes its newest task first and steals the oldest task of
+ * another queue when its own is empty. Threads waiting in parallelFor()
+ * run queued tasks as well, so nested parallel loops cannot deadlock.
+*/
+class CThreadPool {
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<int> m_pending;
+    std::atomic<bool> m_stop;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+
+    CThreadPool(int threads);
+    void push(int queue, std::function<void()> task);
+    bool runOne(int queue);
+    void workerLoop(int queue);
+    int currentQueue() const;
+
+public:
+    ~CThreadPool();
+
+    static CThreadPool& instance();
+    static void setThreadCount(int threads);
+
+    int threadCount() const;
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body);
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+/*
+ * Solution of an initial value problem as returned by
+ * CDGLSolver::trajectory(), queried with trajectory(x) at any x between
+ * xStart() and xEnd() without integrating again.
+ *
+ * Every step [x0, x1] with h = x1 - x0 is stored as the coefficients of
+ *
+ *     y(x0 + t*h) = r1 + t*(r2 + (1-t)*(r3 + t*(r4 + (1-t)*r5)))
+ *
+ * with r1 = y0, r2 = y1 - y0, r3 = h*y0' - r2 and r4 = r2 - h*y1' - r3.
+ * With r5 = 0 this is the cubic Hermite interpolant of y and y' at both
+ * ends. Dormand-Prince passes the r5 of its continuous extension, which
+ * makes the interpolant fourth order.
+ *
+ * The coefficients of all steps are kept in one array, so a trajectory
+ * of n steps of dimension d holds about 5*n*d + n doubles.
+*/
+template<typename V>
+class CTrajectory {
+private:
+    static constexpr int COEFFICIENTS = 5;
+
+    int m_dimension;
+    std::vector<double> m_x;
+    std::vector<double> m_start;
+    std::vector<double> m_coefficients;
+
+    int segment(double x) const {
+        if (m_x.size() == 1) {
+            if (x == m_x[0]) return -1;
+            throw std::out_of_range("x is outside the trajectory.");
+        }
+
+        bool forward = m_x.back() >= m_x.front();
+        double low = forward ? m_x.front() : m_x.back();
+        double high = forward ? m_x.back() : m_x.front();
+        if (!(x >= low && x <= high)) {
+            throw std::out_of_range("x is outside the trajectory.");
+        }
+
+        // first step whose end lies at or beyond x in the direction of integration
+        auto end = forward
+            ? std::lower_bound(m_x.begin() + 1, m_x.end(), x)
+            : std::lower_bound(m_x.begin() + 1, m_x.end(), x, [](double node, double value) { return node > value; });
+
+        return std::min<int>(end - m_x.begin(), m_x.size() - 1) - 1;
+    }
+
+public:
+    CTrajectory(double xStart, const V& yStart) : m_dimension(yStart.dimension()), m_x{xStart}, m_start(m_dimension) {
+        // a trajectory without steps still answers x = xStart
+        for (int i = 0; i < m_dimension; i++) {
+            m_start[i] = yStart.get(i);
+        }
+    }
+
+    /*
+     * Appends the step from xEnd() to x with the values and derivatives at
+     * both ends, correction is r5 (see above).
+    */
+    void append(double x, const V& yStart, const V& yEnd, const V& dyStart, const V& dyEnd, const V& correction) {
+        double h = x - m_x.back();
+
+        for (int i = 0; i < m_dimension; i++) {
+            double r2 = yEnd.get(i) - yStart.get(i);
+            double r3 = h * dyStart.get(i) - r2;
+            m_coefficients.push_back(yStart.get(i));
+            m_coefficients.push_back(r2);
+            m_coefficients.push_back(r3);
+            m_coefficients.push_back(r2 - h * dyEnd.get(i) - r3);
+            m_coefficients.push_back(correction.get(i));
+        }
+
+        m_x.push_back(x);
+    }
+
+    void append(double x, const V& yStart, const V& yEnd, const V& dyStart, const V& dyEnd) {
+        append(x, yStart, yEnd, dyStart, dyEnd, V(m_dimension));
+    }
+
+    double xStart() const { return m_x.front(); }
+    double xEnd() const { return m_x.back(); }
+    int steps() const { return m_x.size() - 1; }
+    int dimension() const { return m_dimension; }
+
+    // x at the start of every step and xEnd()
+    const std::vector<double>& nodes() const { return m_x; }
+
+    V operator()(double x) const {
+        int s = segment(x);
+        V result(m_dimension);
+
+        if (s < 0) {
+            for (int i = 0; i < m_dimension; i++) {
+                result[i] = m_start[i];
+            }
+            return result;
+        }
+
+        double t = (x - m_x[s]) / (m_x[s + 1] - m_x[s]);
+        double u = 1 - t;
+        const double* r = &m_coefficients[s * m_dimension * COEFFICIENTS];
+
+        for (int i = 0; i < m_dimension; i++, r += COEFFICIENTS) {
+            result[i] = r[0] + t * (r[1] + u * (r[2] + t * (r[3] + u * r[4])));
+        }
+
+        return result;
+    }
+};
@@ -1,70 +1,316 @@
 #pragma once
 
 #include "CComplex.h"
+#include "CSparseSpectrum.h"
+#include "HelperOutput.h"
 
+#include <bit>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace Helper {
-    inline std::function<void()> muteOutput(bool mute) {
-        std::streambuf* oldCoutStreamBuf = std::cout.rdbuf();
+    /*
+     * Reads the whole file with one read, the parsers below work on the buffer.
+    */
+    inline std::string readFile(const std::string& filename) {
+        std::ifstream fp(filename, std::ios::binary | std::ios::ate);
+        if (!fp) {
+            throw std::runtime_error("Cannot open " + filename + ".");
+        }
+
+        std::string content(fp.tellg(), '\0');
+        fp.seekg(0);
+        fp.read(content.data(), content.size());
+
+        return content;
+    }
+
+    // powers of ten that are exact doubles
+    inline constexpr double POW10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    /*
+     * Parses a double like std::from_chars. A decimal without exponent whose
+     * digits form an integer below 2^53 and that has at most 22 decimals is
+     * that exact integer divided by an exact power of ten, so one correctly
+     * rounded division gives the same result (Clinger's fast path).
+     * Everything else goes to std::from_chars.
+    */
+    inline std::from_chars_result parseDouble(const char* first, const char* last, double& value) {
+        const char* p = first;
+        bool negative = p < last && *p == '-';
+        if (negative) p++;
+
+        std::uint64_t mantissa = 0;
+        const char* digits = p;
+        for (; p < last && (unsigned)(*p - '0') < 10; p++) {
+            mantissa = mantissa * 10 + (*p - '0');
+        }
+
+        int count = p - digits;
+        int decimals = 0;
+        if (p < last && *p == '.') {
+            const char* fraction = ++p;
+            for (; p < last && (unsigned)(*p - '0') < 10; p++) {
+                mantissa = mantissa * 10 + (*p - '0');
+            }
+            decimals = p - fraction;
+            count += decimals;
+        }
 
-        if(mute) {
-            std::ofstream nullStream("/dev/null");
-            std::cout.rdbuf(nullStream.rdbuf());
+        if (count == 0 || count > 19 || decimals > 22 || mantissa > (1ull << 53) || (p < last && (*p | 0x20) == 'e')) {
+            return std::from_chars(first, last, value);
         }
 
-        return [oldCoutStreamBuf, mute]() {
-            if(mute) std::cout.rdbuf(oldCoutStreamBuf);
-        };
+        value = (double)mantissa / POW10[decimals];
+        if (negative) value = -value;
+
+        return {p, std::errc()};
     }
 
-    inline std::vector<CComplex> readValues(const std::string filename) {
-        int i, N, idx;
+    /*
+     * Parses the next whitespace separated number at pos, returns false at
+     * the end of the buffer.
+    */
+    template<typename T>
+    inline bool parseNumber(const std::string& content, std::size_t& pos, T& value) {
+        while (pos < content.size() && (content[pos] == ' ' || content[pos] == '\t' || content[pos] == '\n' || content[pos] == '\r')) pos++;
+        if (pos == content.size()) return false;
+
+        const char* first = content.data() + pos;
+        const char* last = content.data() + content.size();
+        std::from_chars_result result;
+
+        if constexpr (std::is_same_v<T, double>) {
+            result = parseDouble(first, last, value);
+        } else {
+            result = std::from_chars(first, last, value);
+        }
+
+        if (result.ec != std::errc()) {
+            throw std::invalid_argument("Invalid number at offset " + std::to_string(pos) + ".");
+        }
+
+        pos = result.ptr - content.data();
+        return true;
+    }
+
+    /*
+     * Formats value like printf("%.10g"), which is what an ostream with
+     * precision 10 writes. The ten significant digits come from scaling
+     * with an exact power of ten. That product is off by at most 2e-6, so
+     * only values close to a rounding tie need std::to_chars.
+    */
+    inline char* formatDouble(char* out, double value) {
+        if (value == 0 || !std::isfinite(value)) {
+            return std::to_chars(out, out + 32, value, std::chars_format::general, 10).ptr;
+        }
+
+        // the binary exponent gives the decimal one up to an off by one, fixed below
+        double magnitude = std::fabs(value);
+        int binaryExponent = (int)((std::bit_cast<std::uint64_t>(magnitude) >> 52) & 0x7ff) - 1023;
+        int exponent = binaryExponent * 78913 >> 18;
+        double scaled = 0;
+
+        for (int attempt = 0; attempt < 2; attempt++) {
+            int k = 9 - exponent;
+            if (k < -22 || k > 22) {
+                return std::to_chars(out, out + 32, value, std::chars_format::general, 10).ptr;
+            }
+
+            scaled = k >= 0 ? magnitude * POW10[k] : magnitude / POW10[-k];
+            if (scaled >= 1e10) exponent++;
+            else if (scaled < 1e9) exponent--;
+            else break;
+        }
+
+        if (scaled < 1e9 || scaled >= 1e10) {
+            return std::to_chars(out, out + 32, value, std::chars_format::general, 10).ptr;
+        }
+
+        std::uint64_t significand = scaled;
+        double fraction = scaled - significand;
+        if (std::fabs(fraction - 0.5) < 1e-5) {
+            return std::to_chars(out, out + 32, value, std::chars_format::general, 10).ptr;
+        }
+
+        if (fraction > 0.5) significand++;
+        if (significand == 10000000000ull) {
+            significand = 1000000000ull;
+            exponent++;
+        }
+
+        char digits[10];
+        for (int i = 9; i >= 0; i--) {
+            digits[i] = '0' + significand % 10;
+            significand /= 10;
+        }
+
+        int count = 10;
+        while (digits[count - 1] == '0') count--;
+
+        if (value < 0) *out++ = '-';
+
+        if (exponent < -4 || exponent >= 10) {
+            *out++ = digits[0];
+            if (count > 1) {
+                *out++ = '.';
+                for (int i = 1; i < count; i++) *out++ = digits[i];
+            }
+
+            *out++ = 'e';
+            *out++ = exponent < 0 ? '-' : '+';
+            int e = std::abs(exponent);
+            if (e >= 100) *out++ = '0' + e / 100;
+            *out++ = '0' + e / 10 % 10;
+            *out++ = '0' + e % 10;
+        } else if (exponent >= 0) {
+            for (int i = 0; i <= exponent; i++) *out++ = digits[i];
+            if (count > exponent + 1) {
+                *out++ = '.';
+                for (int i = exponent + 1; i < count; i++) *out++ = digits[i];
+            }
+        } else {
+            *out++ = '0';
+            *out++ = '.';
+            for (int i = 0; i < -exponent - 1; i++) *out++ = '0';
+            for (int i = 0; i < count; i++) *out++ = digits[i];
+        }
+
+        return out;
+    }
+
+    /*
+     * Calls start(N) with the length and record(idx, value) for every line
+     * of a file in the format of writeValues().
+    */
+    template<typename Start, typename Record>
+    inline void parseValues(const std::string& filename, Start start, Record record) {
+        std::string content = readFile(filename);
+        std::size_t pos = 0;
+        int N, idx;
         double re, im;
+
+        if (!parseNumber(content, pos, N) || N < 0) {
+            throw std::invalid_argument(filename + " does not start with a length.");
+        }
+
+        start(N);
+
+        while (parseNumber(content, pos, idx)) {
+            if (!parseNumber(content, pos, re) || !parseNumber(content, pos, im)) {
+                throw std::invalid_argument(filename + " ends inside a record.");
+            }
+            if (idx < 0 || idx >= N) {
+                throw std::out_of_range(filename + " contains index " + std::to_string(idx) + ".");
+            }
+
+            record(idx, CComplex(re, im));
+        }
+    }
+
+    inline std::vector<CComplex> readValues(const std::string filename) {
         std::vector<CComplex> values;
-         
-        std::ifstream fp;
-        fp.open(filename);
-        
-        fp >> N;
-        
-        values.resize(N);
-        CComplex null(0,0);
-        for (i = 0; i < N; i++)
-            values[i] = null;
-       
-        while (!fp.eof())
-        {
-            fp >> idx >> re >> im;
-            CComplex a(re,im);
-            values[idx] = a;
-        }
-         
-        fp.close();
+
+        parseValues(filename, [&values](int N) {
+            values.resize(N);
+        }, [&values](int idx, const CComplex& value) {
+            values[idx] = value;
+        });
 
         return values;
     }
 
-    inline void writeValues(const std::string dateiname, std::vector<CComplex> values, double epsilon = -1)
-    {
-        int i;
-        int N = values.size();
+    /*
+     * Reads a file in the same format as readValues() without filling in the
+     * missing indices, the lines must be sorted by index.
+    */
+    inline CSparseSpectrum readSparseValues(const std::string filename) {
+        CSparseSpectrum spectrum(0);
+
+        parseValues(filename, [&spectrum](int N) {
+            spectrum = CSparseSpectrum(N);
+        }, [&spectrum](int idx, const CComplex& value) {
+            spectrum.add(idx, value);
+        });
+
+        return spectrum;
+    }
+
+    /*
+     * Writes the length and the lines "i re im" for all values with
+     * |value| > epsilon. Numbers are formatted like an ostream with
+     * precision 10 into a buffer that is written in large chunks.
+    */
+    inline void writeRecords(const std::string& dateiname, int N, const std::vector<CComplex>& values, double epsilon) {
+        const std::size_t CHUNK = 1 << 16;
+        const std::size_t RECORD = 64;
+
+        std::ofstream fp(dateiname, std::ios::binary);
+        std::string buffer(CHUNK + RECORD, '\0');
+        char* out = buffer.data();
+
+        out = std::to_chars(out, out + RECORD, N).ptr;
+        *out++ = '\n';
+
+        for (int i = 0; i < values.size(); i++) {
+            if (!(values[i].abs() > epsilon)) continue;
 
-        std::ofstream fp;
-        fp.open(dateiname);
+            out = std::to_chars(out, out + RECORD, i).ptr;
+            *out++ = '\t';
+            out = formatDouble(out, values[i].re());
+            *out++ = '\t';
+            out = formatDouble(out, values[i].im());
+            *out++ = '\n';
 
-        fp << N << std::endl;
+            if (out - buffer.data() >= CHUNK) {
+                fp.write(buffer.data(), out - buffer.data());
+                out = buffer.data();
+            }
+        }
 
-        fp.precision(10);
-        for (i = 0; i < N; i++)
-            if (values[i].abs() > epsilon)
-                fp << i << "\t" << values[i].re() << "\t" << values[i].im() << std::endl;
-        
+        fp.write(buffer.data(), out - buffer.data());
         fp.close();
+
+        if (!fp) {
+            throw std::runtime_error("Cannot write " + dateiname + ".");
+        }
+    }
+
+    inline void writeValues(const std::string dateiname, const std::vector<CComplex>& values, double epsilon = -1)
+    {
+        writeRecords(dateiname, values.size(), values, epsilon);
+    }
+
+    inline std::vector<double> readRealValues(const std::string filename) {
+        std::vector<CComplex> values = readValues(filename);
+        std::vector<double> result(values.size());
+
+        for (int i = 0; i < values.size(); i++) {
+            result[i] = values[i].re();
+        }
+
+        return result;
+    }
+
+    /*
+     * Writes the N/2+1 bins returned by CComplex::rfft for a signal of
+     * length N. readValues() returns them zero padded to N values, which
+     * CComplex::irfft accepts directly.
+    */
+    inline void writeRealSpectrum(const std::string dateiname, const std::vector<CComplex>& spectrum, int N, double epsilon = -1)
+    {
+        writeRecords(dateiname, N, spectrum, epsilon);
     }
 
     inline double maxDeviation(const std::vector<CComplex>& values1, const std::vector<CComplex>& values2) {
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+
+/*
+ * Output helpers without the file and spectrum dependencies of Helper.h,
+ * for headers like CMyVector.h that only need to mute their debug output.
+*/
+namespace Helper {
+    inline std::function<void()> muteOutput(bool mute) {
+        std::streambuf* oldCoutStreamBuf = std::cout.rdbuf();
+
+        if(mute) {
+            static std::ofstream nullStream("/dev/null");
+            std::cout.rdbuf(nullStream.rdbuf());
+        }
+
+        return [oldCoutStreamBuf, mute]() {
+            if(mute) std::cout.rdbuf(oldCoutStreamBuf);
+        };
+    }
+
+    /*
+     * Mutes std::cout like muteOutput() until the guard goes out of scope,
+     * also when the scope is left by an exception.
+    */
+    class OutputMute {
+    private:
+        std::function<void()> m_unmute;
+
+    public:
+        explicit OutputMute(bool mute) : m_unmute(muteOutput(mute)) {}
+        ~OutputMute() { m_unmute(); }
+
+        OutputMute(const OutputMute&) = delete;
+        OutputMute& operator=(const OutputMute&) = delete;
+    };
+}
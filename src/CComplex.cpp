@@ -1,176 +1,401 @@
 #include "../lib/CComplex.h"
+#include "../lib/CAlignedAllocator.h"
+#include "../lib/CFFTPlan.h"
+#include "../lib/CSparseSpectrum.h"
+#include "../lib/CThreadPool.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
 
-const bool CComplex::DEBUG = false;
+namespace {
+    const int TRANSPOSE_BLOCK = 32;
+    const int PARALLEL_GRAIN = 1 << 12;
+    const int DFT_GRAIN = 16;
+    const int BATCH_LANES = 8;
 
-CComplex::CComplex() : m_re(0), m_im(0) {}
+    // idft() skips the zeros of spectra with at most this fraction of nonzeros
+    const double SPARSE_DENSITY = 0.5;
 
-CComplex::CComplex(double re, double im) : m_re(re), m_im(im) {}
+    using LaneBuffer = std::vector<double, CAlignedAllocator<double, 64>>;
 
-CComplex::CComplex(double phi) : m_re(cos(phi)), m_im(sin(phi)) {}
+    bool hasAtMostNonZeros(const std::vector<CComplex>& values, int limit) {
+        int count = 0;
+        for (const CComplex& c : values) {
+            if (c != CComplex() && ++count > limit) return false;
+        }
 
-CComplex::CComplex(const CComplex& c) : m_re(c.m_re), m_im(c.m_im) {}
+        return true;
+    }
 
-CComplex::~CComplex() {}
+    void checkBatch(std::span<CComplex> data, int n, int howmany, int stride, int dist) {
+        if (n < 0 || howmany < 0 || stride < 1 || dist < 0) {
+            throw std::invalid_argument("Invalid batch layout.");
+        }
 
-double CComplex::re() const {
-    return m_re;
-}
+        if (n > 0 && howmany > 0 && (long long)(howmany - 1) * dist + (long long)(n - 1) * stride >= data.size()) {
+            throw std::invalid_argument("Batch layout exceeds the buffer.");
+        }
 
-double CComplex::im() const {
-    return m_im;
-}
+        // signals b and b + k share an element iff k * dist = m * stride for some m < n,
+        // k * dist only grows with k, so the loop stops after at most n * stride / dist steps
+        for (long long k = 1; n > 0 && k < howmany; k++) {
+            long long offset = k * dist;
+            if (offset >= (long long)n * stride) break;
+            if (offset % stride == 0) {
+                throw std::invalid_argument("Signals of a batch must not overlap.");
+            }
+        }
+    }
 
-double CComplex::abs() const {
-    return sqrt(absSq());
-}
+    /*
+     * Copies lanes signals starting with signal first into split arrays,
+     * element j of signal b goes to index j * lanes + b.
+    */
+    void gatherLanes(std::span<CComplex> data, int n, int first, int lanes, int stride, int dist, LaneBuffer& re, LaneBuffer& im) {
+        for (int j = 0; j < n; j++) {
+            for (int b = 0; b < lanes; b++) {
+                const CComplex& c = data[(long long)(first + b) * dist + (long long)j * stride];
+                re[j * lanes + b] = c.re();
+                im[j * lanes + b] = c.im();
+            }
+        }
+    }
 
-double CComplex::absSq() const {
-    return m_re * m_re + m_im * m_im;
-}
+    void scatterLanes(std::span<CComplex> data, int n, int first, int lanes, int stride, int dist, const LaneBuffer& re, const LaneBuffer& im, double scale) {
+        for (int j = 0; j < n; j++) {
+            for (int b = 0; b < lanes; b++) {
+                data[(long long)(first + b) * dist + (long long)j * stride] = CComplex(re[j * lanes + b], im[j * lanes + b]) * scale;
+            }
+        }
+    }
 
-CComplex& CComplex::operator=(const CComplex& c) {
-    m_re = c.m_re;
-    m_im = c.m_im;
-    return *this;
-}
+    /*
+     * Runs the unnormalized plan on each of the rows of length cols, rows
+     * are spread over the thread pool in chunks of at least PARALLEL_GRAIN values.
+    */
+    void transformRows(std::vector<CComplex>& values, int rows, int cols, bool inverse) {
+        const CFFTPlan& plan = CFFTPlan::get(cols, inverse);
+
+        CThreadPool::instance().parallelFor(0, rows, std::max(1, PARALLEL_GRAIN / cols), [&](int from, int to) {
+            for (int r = from; r < to; r++) {
+                std::span<CComplex> row(values.data() + r * cols, cols);
+                if (std::all_of(row.begin(), row.end(), [](const CComplex& c) { return c == CComplex(); })) continue;
+
+                plan.execute(row);
+            }
+        });
+    }
 
-CComplex& CComplex::operator+=(const CComplex& c) {
-    m_re += c.m_re;
-    m_im += c.m_im;
-    return *this;
+    /*
+     * Writes the transpose of the rows x cols matrix in src to dst, tile by
+     * tile so both sides stay in cache.
+    */
+    void transpose(const std::vector<CComplex>& src, std::vector<CComplex>& dst, int rows, int cols) {
+        for (int rb = 0; rb < rows; rb += TRANSPOSE_BLOCK) {
+            for (int cb = 0; cb < cols; cb += TRANSPOSE_BLOCK) {
+                int rEnd = std::min(rb + TRANSPOSE_BLOCK, rows);
+                int cEnd = std::min(cb + TRANSPOSE_BLOCK, cols);
+
+                for (int r = rb; r < rEnd; r++) {
+                    for (int c = cb; c < cEnd; c++) {
+                        dst[c * rows + r] = src[r * cols + c];
+                    }
+                }
+            }
+        }
+    }
 }
 
-CComplex& CComplex::operator-=(const CComplex& c) {
-    m_re -= c.m_re;
-    m_im -= c.m_im;
-    return *this;
-}
+const bool CComplex::DEBUG = false;
 
-CComplex& CComplex::operator*=(const CComplex& c) {
-    double re = m_re * c.m_re - m_im * c.m_im;
-    double im = m_re * c.m_im + m_im * c.m_re;
-    m_re = re;
-    m_im = im;
-    return *this;
+std::string CComplex::to_string() const {
+    return std::to_string(m_re) + " + " + std::to_string(m_im) + "j";
 }
 
-CComplex& CComplex::operator/=(const CComplex& c) {
-    double re = (m_re * c.m_re + m_im * c.m_im) / c.absSq();
-    double im = (m_im * c.m_re - m_re * c.m_im) / c.absSq();
-    m_re = re;
-    m_im = im;
-    return *this;
+std::vector<CComplex> CComplex::dft(const std::vector<CComplex>& values) {
+    int N = values.size();
+    std::vector<CComplex> result(N);
+    if (N == 0) return result;
+
+    const CFFTPlan& plan = CFFTPlan::get(N);
+    CThreadPool::instance().parallelFor(0, N, DFT_GRAIN, [&](int from, int to) {
+        for (int k = from; k < to; k++) {
+            CComplex sum;
+            for (int n = 0, idx = 0; n < N; n++) {
+                sum += values[n] * plan.twiddle(idx);
+                idx += k;
+                if (idx >= N) idx -= N;
+            }
+            result[k] = sum / sqrt(N);
+        }
+    });
+    return result;
 }
 
-CComplex& CComplex::operator*=(double d) {
-    m_re *= d;
-    m_im *= d;
-    return *this;
-}
+/*
+ * Thresholded spectra are mostly zeros, for them the sum runs over the
+ * nonzero coefficients only (CSparseSpectrum::idft, same result).
+*/
+std::vector<CComplex> CComplex::idft(const std::vector<CComplex>& values) {
+    int N = values.size();
+    if (hasAtMostNonZeros(values, N * SPARSE_DENSITY)) {
+        return CSparseSpectrum(values).idft();
+    }
 
-CComplex& CComplex::operator/=(double d) {
-    m_re /= d;
-    m_im /= d;
-    return *this;
-}
+    std::vector<CComplex> result(N);
 
-CComplex CComplex::operator+(const CComplex& c) const {
-    return CComplex(*this) += c;
+    const CFFTPlan& plan = CFFTPlan::get(N, true);
+    CThreadPool::instance().parallelFor(0, N, DFT_GRAIN, [&](int from, int to) {
+        for (int n = from; n < to; n++) {
+            CComplex sum;
+            for (int k = 0, idx = 0; k < N; k++) {
+                sum += values[k] * plan.twiddle(idx);
+                idx += n;
+                if (idx >= N) idx -= N;
+            }
+            result[n] = sum / sqrt(N);
+        }
+    });
+    return result;
 }
 
-CComplex CComplex::operator-(const CComplex& c) const {
-    return CComplex(*this) -= c;
-}
+std::vector<CComplex> CComplex::fft(const std::vector<CComplex>& values, bool inverse) {
+    if (inverse && hasAtMostNonZeros(values, CSparseSpectrum::directLimit(values.size()))) {
+        return CSparseSpectrum(values).idft();
+    }
 
-CComplex CComplex::operator*(const CComplex& c) const {
-    return CComplex(*this) *= c;
+    std::vector<CComplex> result(values);
+    fftInPlace(result, inverse);
+    return result;
 }
 
-CComplex CComplex::operator/(const CComplex& c) const {
-    return CComplex(*this) /= c;
-}
+void CComplex::fftInPlace(std::span<CComplex> values, bool inverse) {
+    int N = values.size();
+    if (N == 0) return;
 
-CComplex CComplex::operator*(double d) const {
-    return CComplex(*this) *= d;
-}
+    CFFTPlan::get(N, inverse).execute(values);
 
-CComplex CComplex::operator/(double d) const {
-    return CComplex(*this) /= d;
-}
+    double scale = 1.0 / std::sqrt(N);
 
-bool CComplex::operator==(const CComplex& c) const {
-    return m_re == c.m_re && m_im == c.m_im;
+    for (auto& c : values) {
+        c *= scale;
+    }
 }
 
-bool CComplex::operator!=(const CComplex& c) const {
-    return !(*this == c);
+/*
+ * Transforms howmany signals of length n in place, element j of signal b is
+ * data[b * dist + j * stride]. The signals must not share elements, since
+ * they are transformed in parallel. All signals share one plan, power of two
+ * sizes are transformed BATCH_LANES signals at a time with the batch as
+ * the innermost loop. Groups of signals are spread over the thread pool.
+*/
+void CComplex::fftBatch(std::span<CComplex> data, int n, int howmany, int stride, int dist, bool inverse) {
+    checkBatch(data, n, howmany, stride, dist);
+    if (n == 0 || howmany == 0) return;
+
+    const CFFTPlan& plan = CFFTPlan::get(n, inverse);
+    bool powerOfTwo = (n & (n - 1)) == 0;
+    double scale = 1.0 / std::sqrt(n);
+    int groups = (howmany + BATCH_LANES - 1) / BATCH_LANES;
+
+    CThreadPool::instance().parallelFor(0, groups, 1, [&](int from, int to) {
+        LaneBuffer re(n * BATCH_LANES);
+        LaneBuffer im(n * BATCH_LANES);
+
+        for (int g = from; g < to; g++) {
+            int first = g * BATCH_LANES;
+            int lanes = std::min(BATCH_LANES, howmany - first);
+
+            gatherLanes(data, n, first, lanes, stride, dist, re, im);
+
+            if (powerOfTwo) {
+                plan.executeBatch(re.data(), im.data(), lanes);
+            } else {
+                std::vector<CComplex> signal(n);
+                for (int b = 0; b < lanes; b++) {
+                    for (int j = 0; j < n; j++) {
+                        signal[j] = CComplex(re[j * lanes + b], im[j * lanes + b]);
+                    }
+
+                    plan.execute(signal);
+
+                    for (int j = 0; j < n; j++) {
+                        re[j * lanes + b] = signal[j].re();
+                        im[j * lanes + b] = signal[j].im();
+                    }
+                }
+            }
+
+            scatterLanes(data, n, first, lanes, stride, dist, re, im, scale);
+        }
+    });
 }
 
-std::string CComplex::to_string() const {
-    return std::to_string(m_re) + " + " + std::to_string(m_im) + "j";
+/*
+ * Direct O(n^2) transform of a batch with the same layout as fftBatch.
+*/
+void CComplex::dftBatch(std::span<CComplex> data, int n, int howmany, int stride, int dist, bool inverse) {
+    checkBatch(data, n, howmany, stride, dist);
+    if (n == 0 || howmany == 0) return;
+
+    const CFFTPlan& plan = CFFTPlan::get(n, inverse);
+    double scale = 1.0 / std::sqrt(n);
+    int groups = (howmany + BATCH_LANES - 1) / BATCH_LANES;
+
+    CThreadPool::instance().parallelFor(0, groups, 1, [&](int from, int to) {
+        LaneBuffer re(n * BATCH_LANES);
+        LaneBuffer im(n * BATCH_LANES);
+        LaneBuffer outRe(n * BATCH_LANES);
+        LaneBuffer outIm(n * BATCH_LANES);
+
+        for (int g = from; g < to; g++) {
+            int first = g * BATCH_LANES;
+            int lanes = std::min(BATCH_LANES, howmany - first);
+
+            gatherLanes(data, n, first, lanes, stride, dist, re, im);
+
+            for (int k = 0; k < n; k++) {
+                double* sumRe = outRe.data() + k * lanes;
+                double* sumIm = outIm.data() + k * lanes;
+                std::fill(sumRe, sumRe + lanes, 0.0);
+                std::fill(sumIm, sumIm + lanes, 0.0);
+
+                for (int j = 0, idx = 0; j < n; j++) {
+                    CComplex w = plan.twiddle(idx);
+                    idx += k;
+                    if (idx >= n) idx -= n;
+
+                    for (int b = 0; b < lanes; b++) {
+                        sumRe[b] += w.re() * re[j * lanes + b] - w.im() * im[j * lanes + b];
+                        sumIm[b] += w.re() * im[j * lanes + b] + w.im() * re[j * lanes + b];
+                    }
+                }
+            }
+
+            scatterLanes(data, n, first, lanes, stride, dist, outRe, outIm, scale);
+        }
+    });
 }
 
-std::vector<CComplex> CComplex::dft(const std::vector<CComplex>& values) {
-    int N = values.size();
-    std::vector<CComplex> result(N);
-    for (int k = 0; k < N; k++) {
-        CComplex sum;
-        for (int n = 0; n < N; n++) {
-            sum += values[n] * CComplex(-2 * M_PI * n * k / N);
-        }
-        result[k] = sum / sqrt(N);
+/*
+ * 2D transform of a row-major rows x cols matrix: transforms all rows,
+ * transposes, transforms the former columns and transposes back.
+*/
+std::vector<CComplex> CComplex::fft2d(const std::vector<CComplex>& values, int rows, int cols, bool inverse) {
+    if (rows <= 0 || cols <= 0 || values.size() != rows * cols) {
+        throw std::invalid_argument("Values must contain rows * cols entries.");
     }
+
+    std::vector<CComplex> result(values);
+    std::vector<CComplex> transposed(values.size());
+
+    transformRows(result, rows, cols, inverse);
+    transpose(result, transposed, rows, cols);
+    transformRows(transposed, cols, rows, inverse);
+    transpose(transposed, result, cols, rows);
+
+    double scale = 1.0 / std::sqrt(rows * cols);
+
+    for (auto& c : result) {
+        c *= scale;
+    }
+
     return result;
 }
 
-std::vector<CComplex> CComplex::idft(const std::vector<CComplex>& values) {
+/*
+ * Transform of a real signal, returns the N/2+1 bins X[0..N/2], the rest
+ * follows from X[N-k] = conj(X[k]). Even sizes run as a complex FFT of
+ * half the length on z[n] = x[2n] + i*x[2n+1].
+*/
+std::vector<CComplex> CComplex::rfft(const std::vector<double>& values) {
     int N = values.size();
-    std::vector<CComplex> result(N);
-    for (int n = 0; n < N; n++) {
-        CComplex sum;
-        for (int k = 0; k < N; k++) {
-            sum += values[k] * CComplex(2 * M_PI * n * k / N);
+    if (N == 0) return {};
+
+    std::vector<CComplex> result(N / 2 + 1);
+
+    if (N % 2 != 0) {
+        std::vector<CComplex> full(N);
+        for (int n = 0; n < N; n++) {
+            full[n] = CComplex(values[n], 0);
         }
-        result[n] = sum / sqrt(N);
+
+        fftInPlace(full);
+        std::copy(full.begin(), full.begin() + result.size(), result.begin());
+        return result;
     }
-    return result;
-}
 
-std::vector<CComplex> CComplex::fft(const std::vector<CComplex>& values, bool inverse) {
-    auto result = fftRecursive(values, inverse);
+    int M = N / 2;
+    std::vector<CComplex> z(M);
+    for (int n = 0; n < M; n++) {
+        z[n] = CComplex(values[2 * n], values[2 * n + 1]);
+    }
 
-    double scale = 1.0 / std::sqrt(result.size());
+    CFFTPlan::get(M).execute(z);
 
-    for(auto &c : result) {
-        c *= scale;
+    const CFFTPlan& plan = CFFTPlan::get(N);
+    double scale = 1.0 / std::sqrt(N);
+
+    for (int k = 0; k <= M; k++) {
+        CComplex a = z[k % M];
+        CComplex b = z[(M - k) % M];
+        CComplex even = CComplex(a.re() + b.re(), a.im() - b.im()) * 0.5;
+        CComplex odd = CComplex(a.im() + b.im(), b.re() - a.re()) * 0.5;
+
+        result[k] = (even + plan.twiddle(k % N) * odd) * scale;
     }
 
     return result;
 }
 
-std::vector<CComplex> CComplex::fftRecursive(const std::vector<CComplex>& values, bool inverse) {
-    int N = values.size();
-    if (N == 1) return values;
+/*
+ * Inverse of rfft for a signal of length N, only spectrum[0..N/2] is read.
+*/
+std::vector<double> CComplex::irfft(const std::vector<CComplex>& spectrum, int N) {
+    if (N == 0) return {};
 
-    std::vector<CComplex> even(N / 2), odd(N / 2);
-    for (int i = 0; i < N / 2; i++) {
-        even[i] = values[2 * i];
-        odd[i] = values[2 * i + 1];
+    if (spectrum.size() < N / 2 + 1) {
+        throw std::invalid_argument("Spectrum must contain at least N/2+1 values.");
     }
 
-    even = fftRecursive(even, inverse);
-    odd = fftRecursive(odd, inverse);
+    std::vector<double> result(N);
 
-    double factor = (inverse ? 2.0 : -2.0) * M_PI / N;
+    if (N % 2 != 0) {
+        std::vector<CComplex> full(N);
+        full[0] = spectrum[0];
+        for (int k = 1; k <= N / 2; k++) {
+            full[k] = spectrum[k];
+            full[N - k] = CComplex(spectrum[k].re(), -spectrum[k].im());
+        }
 
-    std::vector<CComplex> result(N);
-    for (int k = 0; k < N / 2; k++) {
-        CComplex t = CComplex(factor * k) * odd[k];
+        fftInPlace(full, true);
+        for (int n = 0; n < N; n++) {
+            result[n] = full[n].re();
+        }
+        return result;
+    }
+
+    int M = N / 2;
+    std::vector<CComplex> z(M);
+    const CFFTPlan& plan = CFFTPlan::get(N, true);
+
+    for (int k = 0; k < M; k++) {
+        CComplex a = spectrum[k];
+        CComplex b = spectrum[M - k];
+        CComplex even = CComplex(a.re() + b.re(), a.im() - b.im()) * 0.5;
+        CComplex odd = CComplex(a.re() - b.re(), a.im() + b.im()) * 0.5 * plan.twiddle(k);
+
+        z[k] = even + CComplex(-odd.im(), odd.re());
+    }
+
+    CFFTPlan::get(M, true).execute(z);
+
+    double scale = 2.0 / std::sqrt(N);
 
-        result[k] = even[k] + t;
-        result[k + N / 2] = even[k] - t;
+    for (int n = 0; n < M; n++) {
+        result[2 * n] = z[n].re() * scale;
+        result[2 * n + 1] = z[n].im() * scale;
     }
 
     return result;
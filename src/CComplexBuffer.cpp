@@ -0,0 +1,73 @@
+#include "../lib/CComplexBuffer.h"
+#include "../lib/CFFTPlan.h"
+#include <cmath>
+#include <stdexcept>
+
+CComplexBuffer::CComplexBuffer(int size) : m_re(size), m_im(size) {}
+
+CComplexBuffer::CComplexBuffer(const std::vector<CComplex>& values) : m_re(values.size()), m_im(values.size()) {
+    for (int i = 0; i < values.size(); i++) {
+        m_re[i] = values[i].re();
+        m_im[i] = values[i].im();
+    }
+}
+
+int CComplexBuffer::size() const {
+    return m_re.size();
+}
+
+double* CComplexBuffer::re() {
+    return m_re.data();
+}
+
+double* CComplexBuffer::im() {
+    return m_im.data();
+}
+
+const double* CComplexBuffer::re() const {
+    return m_re.data();
+}
+
+const double* CComplexBuffer::im() const {
+    return m_im.data();
+}
+
+CComplex CComplexBuffer::get(int index) const {
+    if (index < 0 || index >= size()) {
+        throw std::out_of_range("Index out of range.");
+    }
+
+    return CComplex(m_re[index], m_im[index]);
+}
+
+void CComplexBuffer::set(int index, const CComplex& value) {
+    if (index < 0 || index >= size()) {
+        throw std::out_of_range("Index out of range.");
+    }
+
+    m_re[index] = value.re();
+    m_im[index] = value.im();
+}
+
+std::vector<CComplex> CComplexBuffer::toVector() const {
+    std::vector<CComplex> result(size());
+    for (int i = 0; i < size(); i++) {
+        result[i] = CComplex(m_re[i], m_im[i]);
+    }
+
+    return result;
+}
+
+void CComplexBuffer::fft(bool inverse) {
+    int N = size();
+    if (N == 0) return;
+
+    CFFTPlan::get(N, inverse).execute(m_re.data(), m_im.data());
+
+    double scale = 1.0 / std::sqrt(N);
+
+    for (int i = 0; i < N; i++) {
+        m_re[i] *= scale;
+        m_im[i] *= scale;
+    }
+}
@@ -0,0 +1,210 @@
+#include "../lib/CFFTConvolver.h"
+#include "../lib/CFFTPlan.h"
+#include "../lib/Helper.h"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+CFFTConvolver::CFFTConvolver(const std::vector<CComplex>& kernel, int blockSize, Method method)
+    : m_blockSize(blockSize), m_kernelSize(kernel.size()), m_method(method) {
+    if (blockSize <= 0 || kernel.empty()) {
+        throw std::invalid_argument("Block size and kernel must not be empty.");
+    }
+
+    m_fftSize = 1;
+    while (m_fftSize < m_blockSize + m_kernelSize - 1) m_fftSize <<= 1;
+
+    m_response = std::vector<CComplex>(m_fftSize);
+    std::copy(kernel.begin(), kernel.end(), m_response.begin());
+    CFFTPlan::get(m_fftSize).execute(m_response);
+
+    // folds the 1/M of the unnormalized inverse transform into the response
+    for (auto& c : m_response) {
+        c /= m_fftSize;
+    }
+
+    m_buffer = std::vector<CComplex>(m_fftSize);
+    m_overlap = std::vector<CComplex>(method == Method::OverlapAdd ? m_fftSize : m_kernelSize - 1);
+}
+
+CFFTConvolver::CFFTConvolver(std::function<void(std::span<CComplex>)> filter, int blockSize)
+    : m_blockSize(blockSize), m_fftSize(2 * blockSize), m_kernelSize(blockSize + 1),
+      m_method(Method::OverlapAdd), m_spectralFilter(filter) {
+    if (blockSize <= 0) {
+        throw std::invalid_argument("Block size must be positive.");
+    }
+
+    m_buffer = std::vector<CComplex>(m_fftSize);
+    m_overlap = std::vector<CComplex>(m_fftSize);
+}
+
+/*
+ * Spectral filter dropping all coefficients with |c| <= epsilon, the same
+ * rule Helper::writeValues applies to whole spectra.
+*/
+CFFTConvolver CFFTConvolver::threshold(double epsilon, int blockSize) {
+    return CFFTConvolver([epsilon](std::span<CComplex> spectrum) {
+        for (auto& c : spectrum) {
+            if (c.abs() <= epsilon) c = CComplex(0, 0);
+        }
+    }, blockSize);
+}
+
+int CFFTConvolver::blockSize() const {
+    return m_blockSize;
+}
+
+void CFFTConvolver::filterBuffer() {
+    if (m_spectralFilter) {
+        CComplex::fftInPlace(m_buffer);
+        m_spectralFilter(m_buffer);
+        CComplex::fftInPlace(m_buffer, true);
+        return;
+    }
+
+    CFFTPlan::get(m_fftSize).execute(m_buffer);
+    for (int k = 0; k < m_fftSize; k++) {
+        m_buffer[k] *= m_response[k];
+    }
+    CFFTPlan::get(m_fftSize, true).execute(m_buffer);
+}
+
+/*
+ * Filters the next block of at most blockSize() samples and returns the
+ * same number of output samples.
+*/
+std::vector<CComplex> CFFTConvolver::process(std::span<const CComplex> block) {
+    int n = block.size();
+    if (n > m_blockSize) {
+        throw std::invalid_argument("Block is larger than the block size.");
+    }
+
+    if (m_method == Method::OverlapAdd) {
+        std::fill(m_buffer.begin(), m_buffer.end(), CComplex());
+        std::copy(block.begin(), block.end(), m_buffer.begin());
+        filterBuffer();
+
+        for (int i = 0; i < m_fftSize; i++) {
+            m_overlap[i] += m_buffer[i];
+        }
+
+        std::vector<CComplex> result(m_overlap.begin(), m_overlap.begin() + n);
+        std::copy(m_overlap.begin() + n, m_overlap.end(), m_overlap.begin());
+        std::fill(m_overlap.end() - n, m_overlap.end(), CComplex());
+
+        return result;
+    }
+
+    // overlap-save: the first K-1 outputs are aliased and belong to the history
+    int history = m_kernelSize - 1;
+
+    std::fill(m_buffer.begin(), m_buffer.end(), CComplex());
+    std::copy(m_overlap.begin(), m_overlap.end(), m_buffer.begin());
+    std::copy(block.begin(), block.end(), m_buffer.begin() + history);
+    filterBuffer();
+
+    std::vector<CComplex> result(m_buffer.begin() + history, m_buffer.begin() + history + n);
+
+    if (n >= history) {
+        std::copy(block.end() - history, block.end(), m_overlap.begin());
+    } else {
+        std::copy(m_overlap.begin() + n, m_overlap.end(), m_overlap.begin());
+        std::copy(block.begin(), block.end(), m_overlap.end() - n);
+    }
+
+    return result;
+}
+
+/*
+ * Returns the samples still pending after the last block (the K-1 tail of
+ * the convolution) and resets the state for the next signal.
+*/
+std::vector<CComplex> CFFTConvolver::flush() {
+    std::vector<CComplex> result;
+    std::vector<CComplex> zeros(m_blockSize);
+
+    for (int remaining = m_kernelSize - 1; remaining > 0; remaining -= m_blockSize) {
+        std::vector<CComplex> tail = process(std::span<const CComplex>(zeros.data(), std::min(remaining, m_blockSize)));
+        result.insert(result.end(), tail.begin(), tail.end());
+    }
+
+    reset();
+    return result;
+}
+
+void CFFTConvolver::reset() {
+    std::fill(m_overlap.begin(), m_overlap.end(), CComplex());
+}
+
+/*
+ * Streams a signal in the format of the data files (length, then "index re im"
+ * lines with increasing indices, missing indices are zero) from in to out.
+ * Only one block of input and output is held in memory.
+ *
+ * The output has the length N of the input: the first N samples of the
+ * filtered signal are written, the tail of the linear convolution that
+ * reaches past N is dropped. Values are written with 10 significant
+ * digits without changing the stream's formatting state.
+*/
+void CFFTConvolver::process(std::istream& in, std::ostream& out) {
+    int N;
+    if (!(in >> N)) {
+        throw std::invalid_argument("Missing signal length.");
+    }
+
+    reset();
+
+    out << N << "\n";
+
+    std::vector<CComplex> block;
+    block.reserve(m_blockSize);
+    int next = 0;
+    int written = 0;
+
+    auto emit = [&](const std::vector<CComplex>& samples) {
+        char line[96];
+        for (const CComplex& c : samples) {
+            if (written >= N) break;
+
+            char* end = std::to_chars(line, line + 16, written++).ptr;
+            *end++ = '\t';
+            end = Helper::formatDouble(end, c.re());
+            *end++ = '\t';
+            end = Helper::formatDouble(end, c.im());
+            *end++ = '\n';
+            out.write(line, end - line);
+        }
+    };
+
+    auto push = [&](const CComplex& c) {
+        block.push_back(c);
+        if ((int)block.size() == m_blockSize) {
+            emit(process(block));
+            block.clear();
+        }
+    };
+
+    int idx;
+    double re, im;
+    while (in >> idx >> re >> im) {
+        if (idx < next || idx >= N) {
+            throw std::invalid_argument("Sample indices must be increasing and below the signal length.");
+        }
+
+        for (; next < idx; next++) {
+            push(CComplex());
+        }
+        push(CComplex(re, im));
+        next++;
+    }
+
+    for (; next < N; next++) {
+        push(CComplex());
+    }
+
+    if (!block.empty()) {
+        emit(process(block));
+    }
+
+    reset();
+}
@@ -0,0 +1,478 @@
+#include "../lib/CFFTPlan.h"
+#include "../lib/CThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    const int PARALLEL_MIN_SIZE = 1 << 14;
+    const int PARALLEL_GRAIN = 1 << 11;
+
+    using ButterflyKernel = void (*)(double* re, double* im, int N, int half, const double* wr, const double* wi);
+
+    /*
+     * One radix-2 stage on split arrays: combines the blocks of length
+     * 2*half, wr/wi hold the half twiddles of the stage contiguously.
+    */
+    void butterflyScalar(double* re, double* im, int N, int half, const double* wr, const double* wi) {
+        for (int i = 0; i < N; i += 2 * half) {
+            for (int k = i; k < i + half; k++) {
+                double tr = wr[k - i] * re[k + half] - wi[k - i] * im[k + half];
+                double ti = wr[k - i] * im[k + half] + wi[k - i] * re[k + half];
+
+                re[k + half] = re[k] - tr;
+                im[k + half] = im[k] - ti;
+                re[k] += tr;
+                im[k] += ti;
+            }
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2,fma")))
+    void butterflyAVX2(double* re, double* im, int N, int half, const double* wr, const double* wi) {
+        for (int i = 0; i < N; i += 2 * half) {
+            double* ar = re + i;
+            double* ai = im + i;
+            double* br = ar + half;
+            double* bi = ai + half;
+
+            for (int k = 0; k < half; k += 4) {
+                __m256d cr = _mm256_loadu_pd(wr + k);
+                __m256d ci = _mm256_loadu_pd(wi + k);
+                __m256d xr = _mm256_loadu_pd(br + k);
+                __m256d xi = _mm256_loadu_pd(bi + k);
+                __m256d yr = _mm256_loadu_pd(ar + k);
+                __m256d yi = _mm256_loadu_pd(ai + k);
+
+                __m256d tr = _mm256_fmsub_pd(cr, xr, _mm256_mul_pd(ci, xi));
+                __m256d ti = _mm256_fmadd_pd(cr, xi, _mm256_mul_pd(ci, xr));
+
+                _mm256_storeu_pd(br + k, _mm256_sub_pd(yr, tr));
+                _mm256_storeu_pd(bi + k, _mm256_sub_pd(yi, ti));
+                _mm256_storeu_pd(ar + k, _mm256_add_pd(yr, tr));
+                _mm256_storeu_pd(ai + k, _mm256_add_pd(yi, ti));
+            }
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void butterflyAVX512(double* re, double* im, int N, int half, const double* wr, const double* wi) {
+        for (int i = 0; i < N; i += 2 * half) {
+            double* ar = re + i;
+            double* ai = im + i;
+            double* br = ar + half;
+            double* bi = ai + half;
+
+            for (int k = 0; k < half; k += 8) {
+                __m512d cr = _mm512_loadu_pd(wr + k);
+                __m512d ci = _mm512_loadu_pd(wi + k);
+                __m512d xr = _mm512_loadu_pd(br + k);
+                __m512d xi = _mm512_loadu_pd(bi + k);
+                __m512d yr = _mm512_loadu_pd(ar + k);
+                __m512d yi = _mm512_loadu_pd(ai + k);
+
+                __m512d tr = _mm512_fmsub_pd(cr, xr, _mm512_mul_pd(ci, xi));
+                __m512d ti = _mm512_fmadd_pd(cr, xi, _mm512_mul_pd(ci, xr));
+
+                _mm512_storeu_pd(br + k, _mm512_sub_pd(yr, tr));
+                _mm512_storeu_pd(bi + k, _mm512_sub_pd(yi, ti));
+                _mm512_storeu_pd(ar + k, _mm512_add_pd(yr, tr));
+                _mm512_storeu_pd(ai + k, _mm512_add_pd(yi, ti));
+            }
+        }
+    }
+#endif
+
+    /*
+     * Radix-2 stages on lanes interleaved signals, element j of signal b is
+     * at j * lanes + b. The innermost loop runs across the signals.
+    */
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+    void butterflyLanes(double* re, double* im, int N, int lanes, const double* stageRe, const double* stageIm) {
+        for (int half = 1; half < N; half <<= 1) {
+            for (int i = 0; i < N; i += 2 * half) {
+                for (int k = i; k < i + half; k++) {
+                    double wr = stageRe[half + k - i];
+                    double wi = stageIm[half + k - i];
+                    double* ar = re + k * lanes;
+                    double* ai = im + k * lanes;
+                    double* br = re + (k + half) * lanes;
+                    double* bi = im + (k + half) * lanes;
+
+                    for (int b = 0; b < lanes; b++) {
+                        double tr = wr * br[b] - wi * bi[b];
+                        double ti = wr * bi[b] + wi * br[b];
+
+                        br[b] = ar[b] - tr;
+                        bi[b] = ai[b] - ti;
+                        ar[b] += tr;
+                        ai[b] += ti;
+                    }
+                }
+            }
+        }
+    }
+
+    struct SimdKernel {
+        ButterflyKernel butterfly;
+        int lanes;
+    };
+
+    const SimdKernel& simdKernel() {
+        static const SimdKernel kernel = [] {
+#if defined(__x86_64__) || defined(__i386__)
+            if (__builtin_cpu_supports("avx512f")) return SimdKernel{butterflyAVX512, 8};
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdKernel{butterflyAVX2, 4};
+#endif
+            return SimdKernel{butterflyScalar, 1};
+        }();
+
+        return kernel;
+    }
+}
+
+CFFTPlan::CFFTPlan(int size, bool inverse) : m_size(size), m_inverse(inverse), m_twiddles(size) {
+    if (size <= 0) {
+        throw std::invalid_argument("FFT size must be positive.");
+    }
+
+    double factor = (inverse ? 2.0 : -2.0) * M_PI / size;
+    for (int k = 0; k < size; k++) {
+        m_twiddles[k] = CComplex(factor * k);
+    }
+
+    if ((size & (size - 1)) == 0) {
+        m_algorithm = Algorithm::Radix2;
+        m_bitReverse.resize(size);
+        for (int i = 1, j = 0; i < size; i++) {
+            int bit = size >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            m_bitReverse[i] = j;
+        }
+
+        // twiddles of the stage combining blocks of 2*half start at index half
+        m_stageRe.resize(size);
+        m_stageIm.resize(size);
+        for (int half = 1; half < size; half <<= 1) {
+            for (int k = 0; k < half; k++) {
+                m_stageRe[half + k] = m_twiddles[k * (size / (2 * half))].re();
+                m_stageIm[half + k] = m_twiddles[k * (size / (2 * half))].im();
+            }
+        }
+        return;
+    }
+
+    int rest = size;
+    for (int p : {4, 2, 3, 5}) {
+        while (rest % p == 0) {
+            m_factors.push_back(p);
+            rest /= p;
+        }
+    }
+
+    if (rest == 1) {
+        m_algorithm = Algorithm::MixedRadix;
+        return;
+    }
+
+    // Bluestein: nk = (n^2 + k^2 - (k-n)^2) / 2 turns the transform into a
+    // convolution with the chirp e^(-/+i*pi*n^2/N), done with a power of two FFT.
+    m_algorithm = Algorithm::Bluestein;
+    m_factors.clear();
+
+    int M = 1;
+    while (M < 2 * size - 1) M <<= 1;
+
+    m_chirp.resize(size);
+    for (long long n = 0; n < size; n++) {
+        m_chirp[n] = CComplex((inverse ? M_PI : -M_PI) * ((n * n) % (2LL * size)) / size);
+    }
+
+    m_chirpSpectrum.resize(M);
+    m_chirpSpectrum[0] = CComplex(m_chirp[0].re(), -m_chirp[0].im()) / M;
+    for (int n = 1; n < size; n++) {
+        m_chirpSpectrum[n] = CComplex(m_chirp[n].re(), -m_chirp[n].im()) / M;
+        m_chirpSpectrum[M - n] = m_chirpSpectrum[n];
+    }
+
+    get(M).execute(m_chirpSpectrum);
+}
+
+const CFFTPlan& CFFTPlan::get(int size, bool inverse) {
+    static std::mutex mutex;
+    static std::map<std::pair<int, bool>, std::unique_ptr<CFFTPlan>> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find({size, inverse});
+        if (it != cache.end()) return *it->second;
+    }
+
+    // Built outside the lock, Bluestein plans fetch their power of two plans here.
+    std::unique_ptr<CFFTPlan> plan(new CFFTPlan(size, inverse));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& cached = cache[{size, inverse}];
+    if (!cached) cached = std::move(plan);
+
+    return *cached;
+}
+
+int CFFTPlan::size() const {
+    return m_size;
+}
+
+bool CFFTPlan::inverse() const {
+    return m_inverse;
+}
+
+/*
+ * Returns e^(-2*pi*i*k/N) for forward and e^(2*pi*i*k/N) for inverse plans.
+*/
+const CComplex& CFFTPlan::twiddle(int k) const {
+    return m_twiddles[k];
+}
+
+/*
+ * Unnormalized in-place transform, the caller applies 1/sqrt(N).
+*/
+void CFFTPlan::execute(std::span<CComplex> values) const {
+    if (values.size() != m_size) {
+        throw std::invalid_argument("Buffer size must match the plan size.");
+    }
+
+    switch (m_algorithm) {
+        case Algorithm::Radix2:
+            radix2(values);
+            break;
+        case Algorithm::MixedRadix: {
+            std::vector<CComplex> input(values.begin(), values.end());
+            mixedRadix(values.data(), input.data(), 1, 0);
+            break;
+        }
+        case Algorithm::Bluestein:
+            bluestein(values);
+            break;
+    }
+}
+
+/*
+ * Same transform on split real/imaginary arrays of length N.
+*/
+void CFFTPlan::execute(double* re, double* im) const {
+    int N = m_size;
+
+    if (m_algorithm != Algorithm::Radix2) {
+        std::vector<CComplex> values(N);
+        for (int i = 0; i < N; i++) {
+            values[i] = CComplex(re[i], im[i]);
+        }
+
+        execute(values);
+
+        for (int i = 0; i < N; i++) {
+            re[i] = values[i].re();
+            im[i] = values[i].im();
+        }
+        return;
+    }
+
+    for (int i = 1; i < N; i++) {
+        int j = m_bitReverse[i];
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    const SimdKernel& kernel = simdKernel();
+
+    for (int half = 1; half < N; half <<= 1) {
+        ButterflyKernel butterfly = half < kernel.lanes ? butterflyScalar : kernel.butterfly;
+        butterfly(re, im, N, half, m_stageRe.data() + half, m_stageIm.data() + half);
+    }
+}
+
+/*
+ * Transforms lanes signals stored interleaved in split arrays, element j
+ * of signal b at index j * lanes + b. Needs a power of two size.
+*/
+void CFFTPlan::executeBatch(double* re, double* im, int lanes) const {
+    if (m_algorithm != Algorithm::Radix2) {
+        throw std::invalid_argument("Batched execution needs a power of two size.");
+    }
+
+    int N = m_size;
+
+    for (int i = 1; i < N; i++) {
+        int j = m_bitReverse[i];
+        if (i < j) {
+            std::swap_ranges(re + i * lanes, re + (i + 1) * lanes, re + j * lanes);
+            std::swap_ranges(im + i * lanes, im + (i + 1) * lanes, im + j * lanes);
+        }
+    }
+
+    butterflyLanes(re, im, N, lanes, m_stageRe.data(), m_stageIm.data());
+}
+
+void CFFTPlan::radix2(std::span<CComplex> values) const {
+    int N = m_size;
+
+    for (int i = 1; i < N; i++) {
+        int j = m_bitReverse[i];
+        if (i < j) std::swap(values[i], values[j]);
+    }
+
+    for (int len = 2; len <= N; len <<= 1) {
+        int half = len / 2;
+        int step = N / len;
+
+        // butterfly b combines values[base + k] and values[base + k + half]
+        auto butterflies = [&](int from, int to) {
+            for (int b = from; b < to;) {
+                int base = b / half * len;
+                int k = b % half;
+                int kEnd = std::min(half, k + to - b);
+                b += kEnd - k;
+
+                for (; k < kEnd; k++) {
+                    CComplex t = m_twiddles[k * step] * values[base + k + half];
+
+                    values[base + k + half] = values[base + k] - t;
+                    values[base + k] += t;
+                }
+            }
+        };
+
+        if (N >= PARALLEL_MIN_SIZE) {
+            CThreadPool::instance().parallelFor(0, N / 2, PARALLEL_GRAIN, butterflies);
+        } else {
+            butterflies(0, N / 2);
+        }
+    }
+}
+
+/*
+ * Decimation in time: transforms the sub-sequence in[0], in[stride], ...
+ * into out by splitting it into p = m_factors[stage] interleaved parts of
+ * length m, transforming those recursively and combining them with one
+ * radix-p butterfly pass.
+*/
+void CFFTPlan::mixedRadix(CComplex* out, const CComplex* in, int stride, int stage) const {
+    int p = m_factors[stage];
+    int m = m_size / stride / p;
+    bool parallel = m * p >= PARALLEL_MIN_SIZE;
+
+    if (m == 1) {
+        for (int q = 0; q < p; q++) {
+            out[q] = in[q * stride];
+        }
+    } else if (parallel) {
+        CThreadPool::instance().parallelFor(0, p, 1, [&](int from, int to) {
+            for (int q = from; q < to; q++) {
+                mixedRadix(out + q * m, in + q * stride, stride * p, stage + 1);
+            }
+        });
+    } else {
+        for (int q = 0; q < p; q++) {
+            mixedRadix(out + q * m, in + q * stride, stride * p, stage + 1);
+        }
+    }
+
+    if (parallel) {
+        CThreadPool::instance().parallelFor(0, m, PARALLEL_GRAIN / p, [&](int from, int to) {
+            butterfly(out, stride, p, m, from, to);
+        });
+    } else {
+        butterfly(out, stride, p, m, 0, m);
+    }
+}
+
+/*
+ * Radix-p pass over the p transformed parts of length m in out, handles
+ * the butterflies from <= k < to.
+*/
+void CFFTPlan::butterfly(CComplex* out, int stride, int p, int m, int from, int to) const {
+    if (p == 2) {
+        for (int k = from; k < to; k++) {
+            CComplex t = out[k + m] * m_twiddles[k * stride];
+
+            out[k + m] = out[k] - t;
+            out[k] += t;
+        }
+    } else if (p == 4) {
+        for (int k = from; k < to; k++) {
+            CComplex s0 = out[k + m] * m_twiddles[k * stride];
+            CComplex s1 = out[k + 2 * m] * m_twiddles[2 * k * stride];
+            CComplex s2 = out[k + 3 * m] * m_twiddles[3 * k * stride];
+
+            CComplex s3 = s0 + s2;
+            CComplex s4 = s0 - s2;
+            CComplex s5 = out[k] - s1;
+            CComplex s6 = out[k] + s1;
+
+            // s4 rotated by -i (forward) or i (inverse)
+            CComplex r = m_inverse ? CComplex(-s4.im(), s4.re()) : CComplex(s4.im(), -s4.re());
+
+            out[k] = s6 + s3;
+            out[k + m] = s5 + r;
+            out[k + 2 * m] = s6 - s3;
+            out[k + 3 * m] = s5 - r;
+        }
+    } else {
+        CComplex scratch[5];
+
+        for (int u = from; u < to; u++) {
+            for (int q = 0; q < p; q++) {
+                scratch[q] = out[u + q * m];
+            }
+
+            for (int q1 = 0; q1 < p; q1++) {
+                int k = u + q1 * m;
+                int idx = 0;
+
+                CComplex sum = scratch[0];
+                for (int q = 1; q < p; q++) {
+                    idx += stride * k;
+                    if (idx >= m_size) idx -= m_size;
+                    sum += scratch[q] * m_twiddles[idx];
+                }
+                out[k] = sum;
+            }
+        }
+    }
+}
+
+void CFFTPlan::bluestein(std::span<CComplex> values) const {
+    int N = m_size;
+    int M = m_chirpSpectrum.size();
+
+    std::vector<CComplex> buffer(M);
+    for (int n = 0; n < N; n++) {
+        buffer[n] = values[n] * m_chirp[n];
+    }
+
+    get(M).execute(buffer);
+    for (int k = 0; k < M; k++) {
+        buffer[k] *= m_chirpSpectrum[k];
+    }
+    get(M, true).execute(buffer);
+
+    for (int k = 0; k < N; k++) {
+        values[k] = buffer[k] * m_chirp[k];
+    }
+}
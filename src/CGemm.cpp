@@ -0,0 +1,223 @@
+#include "../lib/CGemm.h"
+#include "../lib/CAlignedAllocator.h"
+#include "../lib/CThreadPool.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    // micro tile of C held in registers
+    const int MR = 6;
+    const int NR = 8;
+
+    // cache blocks: KC x NR panels of B for L1, MC x KC of A for L2, KC x NC of B for L3
+    const int KC = 256;
+    const int MC = 120;
+    const int NC = 2048;
+    static_assert(MC % MR == 0 && NC % NR == 0);
+
+    // below this many multiply-adds packing costs more than it saves
+    const long long SMALL_PRODUCT = 32 * 32 * 32;
+
+    using Buffer = std::vector<double, CAlignedAllocator<double, 64>>;
+    using MicroKernel = void (*)(int kc, const double* a, const double* b, double* c, int ldc);
+
+    /*
+     * c[MR x NR] += a * b for packed panels, a holds MR values and b NR
+     * values per step of k.
+    */
+    void kernelScalar(int kc, const double* a, const double* b, double* c, int ldc) {
+        double acc[MR][NR] = {};
+
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < MR; i++) {
+                double ai = a[p * MR + i];
+                for (int j = 0; j < NR; j++) {
+                    acc[i][j] += ai * b[p * NR + j];
+                }
+            }
+        }
+
+        for (int i = 0; i < MR; i++) {
+            for (int j = 0; j < NR; j++) {
+                c[i * ldc + j] += acc[i][j];
+            }
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2,fma")))
+    void kernelAVX2(int kc, const double* a, const double* b, double* c, int ldc) {
+        __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+        __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+        __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+        __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+        __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+        __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+        for (int p = 0; p < kc; p++) {
+            __m256d b0 = _mm256_load_pd(b);
+            __m256d b1 = _mm256_load_pd(b + 4);
+            __m256d ai;
+
+            ai = _mm256_broadcast_sd(a + 0);
+            c00 = _mm256_fmadd_pd(ai, b0, c00);
+            c01 = _mm256_fmadd_pd(ai, b1, c01);
+            ai = _mm256_broadcast_sd(a + 1);
+            c10 = _mm256_fmadd_pd(ai, b0, c10);
+            c11 = _mm256_fmadd_pd(ai, b1, c11);
+            ai = _mm256_broadcast_sd(a + 2);
+            c20 = _mm256_fmadd_pd(ai, b0, c20);
+            c21 = _mm256_fmadd_pd(ai, b1, c21);
+            ai = _mm256_broadcast_sd(a + 3);
+            c30 = _mm256_fmadd_pd(ai, b0, c30);
+            c31 = _mm256_fmadd_pd(ai, b1, c31);
+            ai = _mm256_broadcast_sd(a + 4);
+            c40 = _mm256_fmadd_pd(ai, b0, c40);
+            c41 = _mm256_fmadd_pd(ai, b1, c41);
+            ai = _mm256_broadcast_sd(a + 5);
+            c50 = _mm256_fmadd_pd(ai, b0, c50);
+            c51 = _mm256_fmadd_pd(ai, b1, c51);
+
+            a += MR;
+            b += NR;
+        }
+
+        __m256d rows[MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+        for (int i = 0; i < MR; i++) {
+            double* row = c + i * ldc;
+            _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), rows[i][0]));
+            _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), rows[i][1]));
+        }
+    }
+#endif
+
+    MicroKernel microKernel() {
+        static const MicroKernel kernel = [] {
+#if defined(__x86_64__) || defined(__i386__)
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return kernelAVX2;
+#endif
+            return kernelScalar;
+        }();
+
+        return kernel;
+    }
+
+    /*
+     * Copies the mc x kc block of a at (ic, pc) into panels of MR rows,
+     * stored k by k. Missing rows of the last panel are zero.
+    */
+    void packA(const CMatrixView& a, int ic, int pc, int mc, int kc, double* out) {
+        for (int ir = 0; ir < mc; ir += MR) {
+            for (int p = 0; p < kc; p++) {
+                for (int i = 0; i < MR; i++) {
+                    *out++ = ir + i < mc ? a(ic + ir + i, pc + p) : 0.0;
+                }
+            }
+        }
+    }
+
+    /*
+     * Copies the kc x nc block of b at (pc, jc) into panels of NR columns,
+     * stored k by k. Missing columns of the last panel are zero.
+    */
+    void packB(const CMatrixView& b, int pc, int jc, int kc, int nc, double* out) {
+        for (int jr = 0; jr < nc; jr += NR) {
+            int width = std::min(NR, nc - jr);
+
+            for (int p = 0; p < kc; p++) {
+                if (width == NR && b.columnStride() == 1) {
+                    const double* row = b.data() + (long long)(pc + p) * b.rowStride() + jc + jr;
+                    std::copy(row, row + NR, out);
+                } else {
+                    for (int j = 0; j < NR; j++) {
+                        out[j] = j < width ? b(pc + p, jc + jr + j) : 0.0;
+                    }
+                }
+                out += NR;
+            }
+        }
+    }
+}
+
+void CGemm::multiply(const CMatrixView& a, const CMatrixView& b, double* c, int ldc) {
+    auto [m, k] = a.dimensions();
+    auto [bk, n] = b.dimensions();
+
+    if (k != bk) {
+        throw std::invalid_argument("Matrix columns must match other matrix rows.");
+    }
+
+    for (int i = 0; i < m; i++) {
+        std::fill(c + (long long)i * ldc, c + (long long)i * ldc + n, 0.0);
+    }
+
+    if ((long long)m * n * k <= SMALL_PRODUCT) {
+        for (int i = 0; i < m; i++) {
+            double* out = c + (long long)i * ldc;
+            for (int p = 0; p < k; p++) {
+                double ai = a(i, p);
+                for (int j = 0; j < n; j++) {
+                    out[j] += ai * b(p, j);
+                }
+            }
+        }
+        return;
+    }
+
+    MicroKernel kernel = microKernel();
+    Buffer packedB((long long)KC * ((std::min(NC, n) + NR - 1) / NR * NR));
+    int blocks = (m + MC - 1) / MC;
+
+    for (int jc = 0; jc < n; jc += NC) {
+        int nc = std::min(NC, n - jc);
+
+        for (int pc = 0; pc < k; pc += KC) {
+            int kc = std::min(KC, k - pc);
+            packB(b, pc, jc, kc, nc, packedB.data());
+
+            CThreadPool::instance().parallelFor(0, blocks, 1, [&](int from, int to) {
+                Buffer packedA((long long)MC * kc);
+                double tile[MR * NR];
+
+                for (int block = from; block < to; block++) {
+                    int ic = block * MC;
+                    int mc = std::min(MC, m - ic);
+                    packA(a, ic, pc, mc, kc, packedA.data());
+
+                    for (int jr = 0; jr < nc; jr += NR) {
+                        const double* panelB = packedB.data() + (long long)jr * kc;
+
+                        for (int ir = 0; ir < mc; ir += MR) {
+                            const double* panelA = packedA.data() + (long long)ir * kc;
+                            double* out = c + (long long)(ic + ir) * ldc + jc + jr;
+
+                            if (ir + MR <= mc && jr + NR <= nc) {
+                                kernel(kc, panelA, panelB, out, ldc);
+                                continue;
+                            }
+
+                            // edge tile: compute the full tile aside and add the valid part
+                            std::fill(tile, tile + MR * NR, 0.0);
+                            kernel(kc, panelA, panelB, tile, NR);
+
+                            for (int i = 0; i < std::min(MR, mc - ir); i++) {
+                                for (int j = 0; j < std::min(NR, nc - jr); j++) {
+                                    out[(long long)i * ldc + j] += tile[i * NR + j];
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+bool CGemm::usesSimd() {
+    return microKernel() != kernelScalar;
+}
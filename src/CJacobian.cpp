@@ -0,0 +1,108 @@
+#include "../lib/CJacobian.h"
+#include "../lib/CThreadPool.h"
+#include <stdexcept>
+
+namespace {
+    /*
+     * Runs column(j) for every column, serially or on the pool. The calls
+     * only write to their own column.
+    */
+    void forEachColumn(int columns, bool parallel, const std::function<void(int)>& column) {
+        if (!parallel) {
+            for (int j = 0; j < columns; j++) {
+                column(j);
+            }
+            return;
+        }
+
+        CThreadPool::instance().parallelFor(0, columns, 1, [&column](int from, int to) {
+            for (int j = from; j < to; j++) {
+                column(j);
+            }
+        });
+    }
+
+    void checkDimension(int expected, int actual) {
+        if (expected != actual) {
+            throw std::invalid_argument("f must return vectors of the same dimension for all arguments.");
+        }
+    }
+}
+
+CMyMatrix CJacobian::compute(const CMyVector& x, Function f, double h, Difference difference, bool parallel) {
+    if (difference == Difference::Forward) {
+        return forward(x, f(x), f, h, parallel);
+    }
+
+    // the dimension of f(x) is only known after the first column
+    int n = x.dimension();
+    std::vector<CMyVector> columns(n, CMyVector(0));
+
+    forEachColumn(n, parallel, [&](int j) {
+        CMyVector plus(x);
+        CMyVector minus(x);
+        plus[j] += h;
+        minus[j] -= h;
+
+        columns[j] = (f(plus) - f(minus)) * (1 / (2 * h));
+    });
+
+    int m = n > 0 ? columns[0].dimension() : f(x).dimension();
+    CMyMatrix result(m, n);
+
+    for (int j = 0; j < n; j++) {
+        checkDimension(m, columns[j].dimension());
+        for (int i = 0; i < m; i++) {
+            result.set(i, j, columns[j].get(i));
+        }
+    }
+
+    return result;
+}
+
+CMyMatrix CJacobian::forward(const CMyVector& x, const CMyVector& fx, Function f, double h, bool parallel) {
+    int n = x.dimension();
+    int m = fx.dimension();
+    CMyMatrix result(m, n);
+
+    forEachColumn(n, parallel, [&](int j) {
+        CMyVector shifted(x);
+        shifted[j] += h;
+
+        CMyVector fShifted = f(shifted);
+        checkDimension(m, fShifted.dimension());
+
+        for (int i = 0; i < m; i++) {
+            result.set(i, j, (fShifted.get(i) - fx.get(i)) / h);
+        }
+    });
+
+    return result;
+}
+
+CMyMatrix CJacobian::complexStep(const std::vector<double>& x, ComplexFunction f, double h, bool parallel) {
+    int n = x.size();
+    std::vector<CComplex> point(n);
+    for (int j = 0; j < n; j++) {
+        point[j] = CComplex(x[j], 0);
+    }
+
+    std::vector<std::vector<CComplex>> columns(n);
+    forEachColumn(n, parallel, [&](int j) {
+        std::vector<CComplex> shifted(point);
+        shifted[j] = CComplex(x[j], h);
+        columns[j] = f(shifted);
+    });
+
+    int m = n > 0 ? columns[0].size() : f(point).size();
+    CMyMatrix result(m, n);
+
+    for (int j = 0; j < n; j++) {
+        checkDimension(m, columns[j].size());
+        for (int i = 0; i < m; i++) {
+            result.set(i, j, columns[j][i].im() / h);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,179 @@
+#include "../lib/CLUDecomposition.h"
+#include "../lib/CMyMatrix.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// pivots below this fraction of the largest entry count as zero
+const double CLUDecomposition::SINGULAR_TOLERANCE = 1e-13;
+
+CLUDecomposition::CLUDecomposition(const CMyMatrix& matrix) : m_sign(1), m_singular(false) {
+    auto [rows, columns] = matrix.dimensions();
+    if (rows != columns) {
+        throw std::invalid_argument("Matrix must be square.");
+    }
+
+    int n = rows;
+    m_size = n;
+    m_lu.assign(matrix.data(), matrix.data() + (long long)n * n);
+    m_permutation.resize(n);
+
+    double scale = 0;
+    for (int i = 0; i < n; i++) {
+        m_permutation[i] = i;
+    }
+    for (double value : m_lu) {
+        scale = std::max(scale, std::abs(value));
+    }
+
+    double* a = m_lu.data();
+
+    for (int k = 0; k < n; k++) {
+        int pivotRow = k;
+        for (int i = k + 1; i < n; i++) {
+            if (std::abs(a[i * n + k]) > std::abs(a[pivotRow * n + k])) {
+                pivotRow = i;
+            }
+        }
+
+        if (pivotRow != k) {
+            std::swap_ranges(a + k * n, a + (k + 1) * n, a + pivotRow * n);
+            std::swap(m_permutation[k], m_permutation[pivotRow]);
+            m_sign = -m_sign;
+        }
+
+        double pivot = a[k * n + k];
+        if (!(std::abs(pivot) > SINGULAR_TOLERANCE * scale)) {
+            m_singular = true;
+            if (pivot == 0) continue;
+        }
+
+        // the row updates run over contiguous memory and vectorize
+        const double* pivotRowData = a + k * n;
+        for (int i = k + 1; i < n; i++) {
+            double* row = a + i * n;
+            double factor = row[k] / pivot;
+            row[k] = factor;
+
+            if (factor == 0) continue;
+            for (int j = k + 1; j < n; j++) {
+                row[j] -= factor * pivotRowData[j];
+            }
+        }
+    }
+}
+
+int CLUDecomposition::size() const {
+    return m_size;
+}
+
+bool CLUDecomposition::singular() const {
+    return m_singular;
+}
+
+double CLUDecomposition::determinant() const {
+    double result = m_sign;
+    for (int i = 0; i < m_size; i++) {
+        result *= m_lu[i * m_size + i];
+    }
+
+    return result;
+}
+
+void CLUDecomposition::checkSolvable(int rows) const {
+    if (rows != m_size) {
+        throw std::invalid_argument("Right-hand side must have as many rows as the matrix.");
+    }
+    if (m_singular) {
+        throw std::invalid_argument("Matrix is singular.");
+    }
+}
+
+CMyVector CLUDecomposition::solve(const CMyVector& b) const {
+    checkSolvable(b.dimension());
+
+    int n = m_size;
+    const double* a = m_lu.data();
+    std::vector<double> x(n);
+
+    // L*y = P*b
+    for (int i = 0; i < n; i++) {
+        double sum = b.get(m_permutation[i]);
+        for (int k = 0; k < i; k++) {
+            sum -= a[i * n + k] * x[k];
+        }
+        x[i] = sum;
+    }
+
+    // U*x = y
+    for (int i = n - 1; i >= 0; i--) {
+        double sum = x[i];
+        for (int k = i + 1; k < n; k++) {
+            sum -= a[i * n + k] * x[k];
+        }
+        x[i] = sum / a[i * n + i];
+    }
+
+    return CMyVector(x);
+}
+
+/*
+ * Solves A*X = B for all columns of B at once. The substitutions combine
+ * whole rows of X, so every right-hand side shares each pass over L and U.
+*/
+CMyMatrix CLUDecomposition::solve(const CMyMatrix& b) const {
+    auto [rows, columns] = b.dimensions();
+    checkSolvable(rows);
+
+    int n = m_size;
+    int m = columns;
+    const double* a = m_lu.data();
+    CMyMatrix result(n, m);
+    double* x = result.data();
+
+    for (int i = 0; i < n; i++) {
+        std::copy(b.data() + (long long)m_permutation[i] * m, b.data() + ((long long)m_permutation[i] + 1) * m, x + (long long)i * m);
+    }
+
+    for (int i = 0; i < n; i++) {
+        double* row = x + (long long)i * m;
+        for (int k = 0; k < i; k++) {
+            double factor = a[i * n + k];
+            if (factor == 0) continue;
+
+            const double* other = x + (long long)k * m;
+            for (int j = 0; j < m; j++) {
+                row[j] -= factor * other[j];
+            }
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        double* row = x + (long long)i * m;
+        for (int k = i + 1; k < n; k++) {
+            double factor = a[i * n + k];
+            if (factor == 0) continue;
+
+            const double* other = x + (long long)k * m;
+            for (int j = 0; j < m; j++) {
+                row[j] -= factor * other[j];
+            }
+        }
+
+        double pivot = a[i * n + i];
+        for (int j = 0; j < m; j++) {
+            row[j] /= pivot;
+        }
+    }
+
+    return result;
+}
+
+CMyMatrix CLUDecomposition::inverse() const {
+    CMyMatrix identity(m_size, m_size);
+    for (int i = 0; i < m_size; i++) {
+        identity.set(i, i, 1.0);
+    }
+
+    return solve(identity);
+}
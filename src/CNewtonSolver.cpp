@@ -0,0 +1,143 @@
+#include "../lib/CNewtonSolver.h"
+#include "../lib/CJacobian.h"
+#include "../lib/CLUDecomposition.h"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+const double CNewtonSolver::STALL_RATIO = 0.9;
+const int CNewtonSolver::MAX_BROYDEN_UPDATES = 50;
+
+namespace {
+    double dot(const CMyVector& a, const CMyVector& b) {
+        double sum = 0;
+        for (int i = 0; i < a.dimension(); i++) {
+            sum += a.get(i) * b.get(i);
+        }
+
+        return sum;
+    }
+}
+
+CNewtonSolver::CNewtonSolver(std::function<CMyVector(const CMyVector&)> f, Method method, int reuse, double h)
+    : m_f(f), m_linearSolver(lu()), m_method(method), m_reuse(reuse), m_h(h), m_tolerance(1e-5), m_maxSteps(50) {
+    if (reuse < 1) {
+        throw std::invalid_argument("The Jacobian must be used for at least one step.");
+    }
+}
+
+CNewtonSolver::LinearSolver CNewtonSolver::lu() {
+    return [](const CMyMatrix& jacobian) -> Factorization {
+        CLUDecomposition factors = jacobian.lu();
+        return [factors](const CMyVector& b) {
+            return factors.solve(b);
+        };
+    };
+}
+
+void CNewtonSolver::setJacobian(std::function<CMyMatrix(const CMyVector&)> jacobian) {
+    m_jacobian = jacobian;
+}
+
+void CNewtonSolver::setLinearSolver(LinearSolver linearSolver) {
+    m_linearSolver = linearSolver;
+}
+
+void CNewtonSolver::setTolerance(double tolerance, int maxSteps) {
+    m_tolerance = tolerance;
+    m_maxSteps = maxSteps;
+}
+
+CNewtonSolver::Method CNewtonSolver::method() const {
+    return m_method;
+}
+
+int CNewtonSolver::reuse() const {
+    return m_reuse;
+}
+
+/*
+ * Broyden's update of the inverse, H+ = (I + u * s^T) * H with
+ * u = (s - H*y) / (s^T * H*y), is kept as the list of (u, s) pairs on top
+ * of the factored Jacobian, so applying H costs one solve and O(k * n).
+*/
+CNewtonSolver::Result CNewtonSolver::solve(const CMyVector& x) const {
+    int evaluations = 0;
+    auto f = [this, &evaluations](const CMyVector& v) {
+        evaluations++;
+        return m_f(v);
+    };
+
+    Result result{x, false, 0, 0, 0, 0};
+    CMyVector fx = f(x);
+
+    Factorization factorization;
+    std::vector<std::pair<CMyVector, CMyVector>> updates;
+    bool refresh = true;
+    int age = 0;
+
+    auto apply = [&factorization, &updates](const CMyVector& b) {
+        CMyVector z = factorization(b);
+        for (const auto& [u, s] : updates) {
+            z = z + u * dot(s, z);
+        }
+
+        return z;
+    };
+
+    for (;;) {
+        result.residual = fx.magnitude();
+        if (result.residual < m_tolerance) {
+            result.converged = true;
+            break;
+        }
+        if (result.iterations >= m_maxSteps) {
+            break;
+        }
+
+        if (refresh) {
+            CMyMatrix jacobian = m_jacobian ? m_jacobian(result.x) : CJacobian::forward(result.x, fx, f, m_h);
+            factorization = m_linearSolver(jacobian);
+            updates.clear();
+            result.jacobians++;
+            age = 0;
+        }
+
+        CMyVector step = apply(fx);
+        CMyVector next = result.x - step;
+        CMyVector fNext = f(next);
+        age++;
+
+        switch (m_method) {
+            case Method::Newton:
+                refresh = true;
+                break;
+            case Method::Shamanskii:
+                refresh = age >= m_reuse;
+                break;
+            case Method::Broyden: {
+                CMyVector s = -step;
+                CMyVector hy = apply(fNext - fx);
+                double denominator = dot(s, hy);
+
+                refresh = updates.size() >= MAX_BROYDEN_UPDATES || !(std::abs(denominator) > 1e-14 * s.magnitude() * hy.magnitude());
+                if (!refresh) {
+                    updates.emplace_back((s - hy) * (1 / denominator), s);
+                }
+                break;
+            }
+        }
+
+        if (fNext.magnitude() > STALL_RATIO * result.residual) {
+            refresh = true;
+        }
+
+        result.x = next;
+        fx = fNext;
+        result.iterations++;
+    }
+
+    result.evaluations = evaluations;
+    return result;
+}
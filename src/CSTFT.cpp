@@ -0,0 +1,77 @@
+#include "../lib/CSTFT.h"
+#include <cmath>
+#include <stdexcept>
+
+CSTFT::CSTFT(int size, int hop, Window window) : m_size(size), m_hop(hop), m_window(window) {
+    if (size <= 0 || hop <= 0) {
+        throw std::invalid_argument("Frame size and hop must be positive.");
+    }
+
+    m_weights = weights(window, size);
+}
+
+std::vector<double> CSTFT::weights(Window window, int size) {
+    std::vector<double> result(size, 1.0);
+
+    for (int n = 0; n < size; n++) {
+        double c = std::cos(2 * M_PI * n / size);
+        if (window == Window::Hann) result[n] = 0.5 - 0.5 * c;
+        if (window == Window::Hamming) result[n] = 0.54 - 0.46 * c;
+    }
+
+    return result;
+}
+
+int CSTFT::size() const {
+    return m_size;
+}
+
+int CSTFT::hop() const {
+    return m_hop;
+}
+
+CSTFT::Window CSTFT::window() const {
+    return m_window;
+}
+
+int CSTFT::frameCount(int length) const {
+    return length < m_size ? 0 : (length - m_size) / m_hop + 1;
+}
+
+std::vector<CComplex> CSTFT::frame(const std::vector<CComplex>& values, int start) const {
+    if (start < 0 || start + m_size > values.size()) {
+        throw std::out_of_range("Frame exceeds the signal.");
+    }
+
+    std::vector<CComplex> result(m_size);
+    for (int n = 0; n < m_size; n++) {
+        result[n] = values[start + n] * m_weights[n];
+    }
+
+    CComplex::fftInPlace(result);
+    return result;
+}
+
+/*
+ * Spectra of all complete frames, frame f starts at sample f * hop().
+ * The frames are transformed together as one batch.
+*/
+std::vector<std::vector<CComplex>> CSTFT::spectrogram(const std::vector<CComplex>& values) const {
+    int frames = frameCount(values.size());
+    std::vector<CComplex> data(frames * m_size);
+
+    for (int f = 0; f < frames; f++) {
+        for (int n = 0; n < m_size; n++) {
+            data[f * m_size + n] = values[f * m_hop + n] * m_weights[n];
+        }
+    }
+
+    CComplex::fftBatch(data, m_size, frames, 1, m_size);
+
+    std::vector<std::vector<CComplex>> result(frames);
+    for (int f = 0; f < frames; f++) {
+        result[f].assign(data.begin() + f * m_size, data.begin() + (f + 1) * m_size);
+    }
+
+    return result;
+}
@@ -0,0 +1,95 @@
+#include "../lib/CSlidingDFT.h"
+#include "../lib/CFFTPlan.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    // windows pushed between two exact recomputations of the bins
+    const int RESYNC_WINDOWS = 16;
+}
+
+CSlidingDFT::CSlidingDFT(int size, CSTFT::Window window)
+    : m_size(size), m_window(window), m_position(0), m_sinceResync(0) {
+    if (size <= 0) {
+        throw std::invalid_argument("Window size must be positive.");
+    }
+
+    const CFFTPlan& plan = CFFTPlan::get(size, true);
+    m_rotation = std::vector<CComplex>(size);
+    for (int k = 0; k < size; k++) {
+        m_rotation[k] = plan.twiddle(k);
+    }
+
+    m_history = std::vector<CComplex>(size);
+    m_bins = std::vector<CComplex>(size);
+}
+
+int CSlidingDFT::size() const {
+    return m_size;
+}
+
+void CSlidingDFT::push(const CComplex& sample) {
+    CComplex delta = sample - m_history[m_position];
+    m_history[m_position] = sample;
+    m_position = (m_position + 1) % m_size;
+
+    for (int k = 0; k < m_size; k++) {
+        m_bins[k] = (m_bins[k] + delta) * m_rotation[k];
+    }
+
+    if (++m_sinceResync >= RESYNC_WINDOWS * m_size) {
+        resync();
+    }
+}
+
+void CSlidingDFT::push(std::span<const CComplex> samples) {
+    for (const CComplex& sample : samples) {
+        push(sample);
+    }
+}
+
+void CSlidingDFT::resync() {
+    for (int n = 0; n < m_size; n++) {
+        m_bins[n] = m_history[(m_position + n) % m_size];
+    }
+
+    CFFTPlan::get(m_size).execute(m_bins);
+    m_sinceResync = 0;
+}
+
+/*
+ * Bin k of the windowed spectrum, normalized like CComplex::fft.
+*/
+CComplex CSlidingDFT::bin(int k) const {
+    if (k < 0 || k >= m_size) {
+        throw std::out_of_range("Bin index out of range.");
+    }
+
+    double scale = 1.0 / std::sqrt(m_size);
+    if (m_window == CSTFT::Window::Rectangular) {
+        return m_bins[k] * scale;
+    }
+
+    double center = m_window == CSTFT::Window::Hann ? 0.5 : 0.54;
+    double side = m_window == CSTFT::Window::Hann ? -0.25 : -0.23;
+    CComplex neighbours = m_bins[(k + m_size - 1) % m_size] + m_bins[(k + 1) % m_size];
+
+    return (m_bins[k] * center + neighbours * side) * scale;
+}
+
+std::vector<CComplex> CSlidingDFT::spectrum() const {
+    std::vector<CComplex> result(m_size);
+    for (int k = 0; k < m_size; k++) {
+        result[k] = bin(k);
+    }
+
+    return result;
+}
+
+void CSlidingDFT::reset() {
+    std::fill(m_history.begin(), m_history.end(), CComplex());
+    std::fill(m_bins.begin(), m_bins.end(), CComplex());
+    m_position = 0;
+    m_sinceResync = 0;
+}
@@ -0,0 +1,128 @@
+#include "../lib/CSparseSpectrum.h"
+#include "../lib/CFFTPlan.h"
+#include "../lib/CThreadPool.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    const int DFT_GRAIN = 16;
+
+    // coefficients per log2(N) below which idft() beats the FFT
+    const double DIRECT_PER_STAGE = 1.0;
+}
+
+CSparseSpectrum::CSparseSpectrum(int size) : m_size(size) {
+    if (size < 0) {
+        throw std::invalid_argument("Spectrum size must not be negative.");
+    }
+}
+
+/*
+ * Keeps the coefficients with |c| > epsilon, the default drops exact zeros.
+*/
+CSparseSpectrum::CSparseSpectrum(const std::vector<CComplex>& values, double epsilon) : m_size(values.size()) {
+    for (int k = 0; k < m_size; k++) {
+        if (values[k].abs() > epsilon) {
+            m_indices.push_back(k);
+            m_values.push_back(values[k]);
+        }
+    }
+}
+
+int CSparseSpectrum::size() const {
+    return m_size;
+}
+
+int CSparseSpectrum::nonZeros() const {
+    return m_indices.size();
+}
+
+double CSparseSpectrum::density() const {
+    return m_size == 0 ? 0 : (double)nonZeros() / m_size;
+}
+
+int CSparseSpectrum::index(int i) const {
+    return m_indices.at(i);
+}
+
+const CComplex& CSparseSpectrum::value(int i) const {
+    return m_values.at(i);
+}
+
+/*
+ * Indices must be added in increasing order, as they appear in the files.
+*/
+void CSparseSpectrum::add(int index, const CComplex& value) {
+    if (index < 0 || index >= m_size) {
+        throw std::out_of_range("Spectrum index out of range.");
+    }
+
+    if (!m_indices.empty() && index <= m_indices.back()) {
+        throw std::invalid_argument("Spectrum indices must be increasing.");
+    }
+
+    m_indices.push_back(index);
+    m_values.push_back(value);
+}
+
+std::vector<CComplex> CSparseSpectrum::toDense() const {
+    std::vector<CComplex> result(m_size);
+
+    for (int i = 0; i < nonZeros(); i++) {
+        result[m_indices[i]] = m_values[i];
+    }
+
+    return result;
+}
+
+/*
+ * Largest number of coefficients for which idft() is faster than an FFT
+ * of size coefficients.
+*/
+int CSparseSpectrum::directLimit(int size) {
+    return size > 1 ? DIRECT_PER_STAGE * std::log2(size) : size;
+}
+
+bool CSparseSpectrum::prefersDirect() const {
+    return nonZeros() <= directLimit(m_size);
+}
+
+/*
+ * Adds one stored coefficient at a time to all outputs. Every output still
+ * sums the coefficients in increasing index order, so the result is
+ * identical to CComplex::idft of the dense spectrum.
+*/
+std::vector<CComplex> CSparseSpectrum::idft() const {
+    int N = m_size;
+    int K = nonZeros();
+    std::vector<CComplex> result(N);
+    if (N == 0) return result;
+
+    const CComplex* twiddles = &CFFTPlan::get(N, true).twiddle(0);
+    CThreadPool::instance().parallelFor(0, N, DFT_GRAIN, [&](int from, int to) {
+        for (int i = 0; i < K; i++) {
+            int k = m_indices[i];
+            const CComplex& c = m_values[i];
+
+            for (int n = from, idx = (long long)k * from % N; n < to; n++) {
+                result[n] += c * twiddles[idx];
+                idx += k;
+                if (idx >= N) idx -= N;
+            }
+        }
+
+        for (int n = from; n < to; n++) {
+            result[n] = result[n] / sqrt(N);
+        }
+    });
+
+    return result;
+}
+
+std::vector<CComplex> CSparseSpectrum::inverse() const {
+    if (prefersDirect()) return idft();
+
+    std::vector<CComplex> result = toDense();
+    CComplex::fftInPlace(result, true);
+    return result;
+}
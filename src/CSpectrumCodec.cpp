@@ -0,0 +1,381 @@
+#include "../lib/CSpectrumCodec.h"
+#include "../lib/Helper.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    const char MAGIC[4] = {'C', 'S', 'P', 'C'};
+    const std::uint8_t VERSION = 1;
+
+    const std::uint8_t RAW = 0;
+    const std::uint8_t RANS = 1;
+
+    // rANS with 32 bit state, byte-wise renormalization and 12 bit frequencies
+    const int SCALE_BITS = 12;
+    const std::uint32_t SCALE = 1u << SCALE_BITS;
+    const std::uint32_t RANS_LOW = 1u << 23;
+
+    // a 64 bit varint takes at most 10 bytes
+    const std::uint64_t MAX_VARINT_BYTES = 10;
+
+    void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(value);
+    }
+
+    std::uint64_t zigzag(std::int64_t value) {
+        return ((std::uint64_t)value << 1) ^ (std::uint64_t)(value >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t value) {
+        return (std::int64_t)(value >> 1) ^ -(std::int64_t)(value & 1);
+    }
+
+    /*
+     * Bounds checked reading of the encoded buffer, every violation means
+     * the data is not a valid spectrum.
+    */
+    class Reader {
+    private:
+        const std::vector<std::uint8_t>& m_data;
+        std::size_t m_pos;
+
+    public:
+        Reader(const std::vector<std::uint8_t>& data, std::size_t pos = 0) : m_data(data), m_pos(pos) {}
+
+        std::size_t position() const { return m_pos; }
+
+        std::uint8_t byte() {
+            if (m_pos >= m_data.size()) throw std::invalid_argument("Compressed spectrum is truncated.");
+            return m_data[m_pos++];
+        }
+
+        std::uint64_t varint() {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                std::uint8_t b = byte();
+                value |= (std::uint64_t)(b & 0x7f) << shift;
+                if (!(b & 0x80)) return value;
+            }
+            throw std::invalid_argument("Compressed spectrum contains an invalid varint.");
+        }
+
+        double real() {
+            std::uint64_t bits = 0;
+            for (int i = 0; i < 8; i++) bits |= (std::uint64_t)byte() << (8 * i);
+            double value;
+            std::memcpy(&value, &bits, 8);
+            return value;
+        }
+
+        const std::uint8_t* take(std::size_t count) {
+            if (count > m_data.size() - m_pos) throw std::invalid_argument("Compressed spectrum is truncated.");
+            const std::uint8_t* p = m_data.data() + m_pos;
+            m_pos += count;
+            return p;
+        }
+    };
+
+    void putReal(std::vector<std::uint8_t>& out, double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, 8);
+        for (int i = 0; i < 8; i++) out.push_back(bits >> (8 * i));
+    }
+
+    /*
+     * Scales the symbol counts to frequencies summing to SCALE, every symbol
+     * that occurs keeps a frequency of at least 1.
+    */
+    std::vector<std::uint32_t> normalize(const std::vector<std::uint64_t>& counts, std::size_t total) {
+        std::vector<std::uint32_t> freq(256, 0);
+        std::int64_t sum = 0;
+
+        for (int s = 0; s < 256; s++) {
+            if (counts[s] == 0) continue;
+            freq[s] = std::max<std::uint64_t>(1, counts[s] * SCALE / total);
+            sum += freq[s];
+        }
+
+        while (sum < SCALE) {
+            (*std::max_element(freq.begin(), freq.end()))++;
+            sum++;
+        }
+
+        // takes from the largest frequency that can still give one
+        while (sum > SCALE) {
+            int s = -1;
+            for (int t = 0; t < 256; t++) {
+                if (freq[t] > 1 && (s < 0 || freq[t] > freq[s])) s = t;
+            }
+            freq[s]--;
+            sum--;
+        }
+
+        return freq;
+    }
+
+    std::vector<std::uint8_t> ransEncode(const std::vector<std::uint8_t>& symbols, const std::vector<std::uint32_t>& freq) {
+        std::vector<std::uint32_t> start(256, 0);
+        for (int s = 1; s < 256; s++) start[s] = start[s - 1] + freq[s - 1];
+
+        std::vector<std::uint8_t> reversed;
+        std::uint32_t x = RANS_LOW;
+
+        for (std::size_t i = symbols.size(); i-- > 0;) {
+            std::uint32_t f = freq[symbols[i]];
+            std::uint32_t limit = ((RANS_LOW >> SCALE_BITS) << 8) * f;
+
+            while (x >= limit) {
+                reversed.push_back(x & 0xff);
+                x >>= 8;
+            }
+
+            x = ((x / f) << SCALE_BITS) + (x % f) + start[symbols[i]];
+        }
+
+        for (int i = 0; i < 4; i++) {
+            reversed.push_back(x & 0xff);
+            x >>= 8;
+        }
+
+        return std::vector<std::uint8_t>(reversed.rbegin(), reversed.rend());
+    }
+
+    std::vector<std::uint8_t> ransDecode(const std::uint8_t* data, std::size_t length, std::size_t count, const std::vector<std::uint32_t>& freq) {
+        std::vector<std::uint32_t> start(256, 0);
+        for (int s = 1; s < 256; s++) start[s] = start[s - 1] + freq[s - 1];
+
+        std::vector<std::uint8_t> slots(SCALE);
+        for (int s = 0; s < 256; s++) {
+            std::fill(slots.begin() + start[s], slots.begin() + start[s] + freq[s], s);
+        }
+
+        if (length < 4) throw std::invalid_argument("Compressed spectrum is truncated.");
+
+        std::size_t pos = 0;
+        std::uint32_t x = 0;
+        for (int i = 0; i < 4; i++) x = (x << 8) | data[pos++];
+
+        std::vector<std::uint8_t> symbols(count);
+        for (std::size_t i = 0; i < count; i++) {
+            std::uint32_t slot = x & (SCALE - 1);
+            std::uint8_t s = slots[slot];
+            symbols[i] = s;
+
+            x = freq[s] * (x >> SCALE_BITS) + slot - start[s];
+            while (x < RANS_LOW) {
+                if (pos >= length) throw std::invalid_argument("Compressed spectrum is truncated.");
+                x = (x << 8) | data[pos++];
+            }
+        }
+
+        return symbols;
+    }
+
+    /*
+     * Block layout: mode, symbol count, [frequency table], payload length, payload.
+    */
+    void putStream(std::vector<std::uint8_t>& out, const std::vector<std::uint8_t>& symbols) {
+        std::vector<std::uint8_t> coded;
+        bool useRans = false;
+
+        if (!symbols.empty()) {
+            std::vector<std::uint64_t> counts(256, 0);
+            for (std::uint8_t s : symbols) counts[s]++;
+            std::vector<std::uint32_t> freq = normalize(counts, symbols.size());
+
+            int used = std::count_if(freq.begin(), freq.end(), [](std::uint32_t f) { return f > 0; });
+            putVarint(coded, used);
+            for (int s = 0; s < 256; s++) {
+                if (freq[s] == 0) continue;
+                coded.push_back(s);
+                putVarint(coded, freq[s]);
+            }
+
+            std::vector<std::uint8_t> payload = ransEncode(symbols, freq);
+            putVarint(coded, payload.size());
+            coded.insert(coded.end(), payload.begin(), payload.end());
+
+            useRans = coded.size() < symbols.size();
+        }
+
+        out.push_back(useRans ? RANS : RAW);
+        putVarint(out, symbols.size());
+
+        if (useRans) {
+            out.insert(out.end(), coded.begin(), coded.end());
+        } else {
+            out.insert(out.end(), symbols.begin(), symbols.end());
+        }
+    }
+
+    /*
+     * A stream holds one varint per entry, so it has at most maxCount symbols.
+     * A single rANS symbol can cost less than a bit, so the payload length
+     * alone does not bound the count.
+    */
+    std::vector<std::uint8_t> takeStream(Reader& in, std::uint64_t maxCount) {
+        std::uint8_t mode = in.byte();
+        std::uint64_t count = in.varint();
+
+        if (count > maxCount) throw std::invalid_argument("Compressed spectrum has an inconsistent stream length.");
+
+        if (mode == RAW) {
+            const std::uint8_t* p = in.take(count);
+            return std::vector<std::uint8_t>(p, p + count);
+        }
+
+        if (mode != RANS) throw std::invalid_argument("Compressed spectrum has an unknown stream mode.");
+
+        std::vector<std::uint32_t> freq(256, 0);
+        std::uint64_t used = in.varint();
+        std::uint64_t sum = 0;
+        for (std::uint64_t i = 0; i < used && i < 256; i++) {
+            std::uint8_t s = in.byte();
+            freq[s] = in.varint();
+            sum += freq[s];
+        }
+
+        if (used > 256 || sum != SCALE) throw std::invalid_argument("Compressed spectrum has an invalid frequency table.");
+
+        std::size_t length = in.varint();
+        return ransDecode(in.take(length), length, count, freq);
+    }
+}
+
+CSpectrumCodec::CSpectrumCodec(double epsilon, double step) : m_epsilon(epsilon), m_step(step) {
+    if (!(step > 0)) {
+        throw std::invalid_argument("Quantization step must be positive.");
+    }
+}
+
+double CSpectrumCodec::epsilon() const {
+    return m_epsilon;
+}
+
+double CSpectrumCodec::step() const {
+    return m_step;
+}
+
+std::vector<std::uint8_t> CSpectrumCodec::encode(const std::vector<CComplex>& spectrum) const {
+    std::vector<std::uint8_t> gaps, re, im;
+    std::uint64_t count = 0;
+    int previous = -1;
+
+    for (int k = 0; k < spectrum.size(); k++) {
+        if (!(spectrum[k].abs() > m_epsilon)) continue;
+
+        double qRe = std::round(spectrum[k].re() / m_step);
+        double qIm = std::round(spectrum[k].im() / m_step);
+        if (std::fabs(qRe) > 9e18 || std::fabs(qIm) > 9e18) {
+            throw std::invalid_argument("Quantization step is too small for the spectrum.");
+        }
+
+        putVarint(gaps, k - previous - 1);
+        putVarint(re, zigzag((std::int64_t)qRe));
+        putVarint(im, zigzag((std::int64_t)qIm));
+        previous = k;
+        count++;
+    }
+
+    std::vector<std::uint8_t> out(MAGIC, MAGIC + sizeof(MAGIC));
+    out.push_back(VERSION);
+    putVarint(out, spectrum.size());
+    putVarint(out, count);
+    putReal(out, m_step);
+    putReal(out, m_epsilon);
+
+    putStream(out, gaps);
+    putStream(out, re);
+    putStream(out, im);
+
+    return out;
+}
+
+std::vector<CComplex> CSpectrumCodec::decode(const std::vector<std::uint8_t>& data) {
+    if (data.size() < sizeof(MAGIC) + 1 || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::invalid_argument("Data is not a compressed spectrum.");
+    }
+
+    Reader in(data, sizeof(MAGIC));
+    if (in.byte() != VERSION) {
+        throw std::invalid_argument("Compressed spectrum has an unsupported version.");
+    }
+
+    std::uint64_t N = in.varint();
+    std::uint64_t count = in.varint();
+    double step = in.real();
+    in.real();
+
+    if (count > N || N > data.size() * (1ull << 20)) {
+        throw std::invalid_argument("Compressed spectrum has an inconsistent header.");
+    }
+
+    // count <= N, so the streams are never larger than the result
+    std::vector<std::uint8_t> gapBytes = takeStream(in, count * MAX_VARINT_BYTES);
+    std::vector<std::uint8_t> reBytes = takeStream(in, count * MAX_VARINT_BYTES);
+    std::vector<std::uint8_t> imBytes = takeStream(in, count * MAX_VARINT_BYTES);
+
+    Reader gaps(gapBytes), re(reBytes), im(imBytes);
+    std::vector<CComplex> result(N);
+    std::uint64_t k = 0;
+
+    for (std::uint64_t i = 0; i < count; i++) {
+        k += gaps.varint() + (i > 0 ? 1 : 0);
+        if (k >= N) throw std::invalid_argument("Compressed spectrum index out of range.");
+
+        result[k] = CComplex(unzigzag(re.varint()) * step, unzigzag(im.varint()) * step);
+    }
+
+    return result;
+}
+
+void CSpectrumCodec::write(const std::string& filename, const std::vector<CComplex>& spectrum) const {
+    std::vector<std::uint8_t> data = encode(spectrum);
+
+    std::ofstream fp(filename, std::ios::binary);
+    fp.write(reinterpret_cast<const char*>(data.data()), data.size());
+    fp.close();
+
+    if (!fp) {
+        throw std::runtime_error("Cannot write " + filename + ".");
+    }
+}
+
+std::vector<CComplex> CSpectrumCodec::read(const std::string& filename) {
+    std::string content = Helper::readFile(filename);
+    return decode(std::vector<std::uint8_t>(content.begin(), content.end()));
+}
+
+/*
+ * Compares the encoded size with the text Helper::writeValues writes for
+ * the same epsilon, and the signal with inverse() of the decoded spectrum.
+*/
+CSpectrumCodec::Report CSpectrumCodec::report(const std::vector<CComplex>& signal, const std::vector<CComplex>& spectrum,
+                                              const std::function<std::vector<CComplex>(const std::vector<CComplex>&)>& inverse) const {
+    Report result = {};
+    char buffer[64];
+
+    result.textBytes = std::to_chars(buffer, buffer + sizeof(buffer), spectrum.size()).ptr - buffer + 1;
+    for (int k = 0; k < spectrum.size(); k++) {
+        if (!(spectrum[k].abs() > m_epsilon)) continue;
+
+        result.nonZeros++;
+        result.textBytes += std::to_chars(buffer, buffer + sizeof(buffer), k).ptr - buffer + 3;
+        result.textBytes += Helper::formatDouble(buffer, spectrum[k].re()) - buffer;
+        result.textBytes += Helper::formatDouble(buffer, spectrum[k].im()) - buffer;
+    }
+
+    std::vector<std::uint8_t> data = encode(spectrum);
+    result.compressedBytes = data.size();
+    result.ratio = (double)result.textBytes / result.compressedBytes;
+    result.maxDeviation = Helper::maxDeviation(signal, inverse(decode(data)));
+
+    return result;
+}
@@ -0,0 +1,228 @@
+#include "../lib/CSpectrumFile.h"
+#include "../lib/Helper.h"
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char MAGIC[4] = {'C', 'S', 'P', 'F'};
+
+    const std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+    const std::uint64_t FNV_PRIME = 1099511628211ull;
+}
+
+CSpectrumFile::CSpectrumFile(const std::string& filename, bool verify) : m_data(nullptr), m_length(0), m_header(nullptr) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + filename + ".");
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error(filename + " is not a spectrum file.");
+    }
+
+    m_length = info.st_size;
+    m_data = mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (m_data == MAP_FAILED) {
+        m_data = nullptr;
+        throw std::runtime_error("Cannot map " + filename + ".");
+    }
+
+    m_header = static_cast<const Header*>(m_data);
+
+    // the mapping is released by the destructor, which does not run if the constructor throws
+    auto fail = [this](const std::string& message) {
+        munmap(m_data, m_length);
+        m_data = nullptr;
+        throw std::runtime_error(message);
+    };
+
+    if (std::memcmp(m_header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        fail(filename + " is not a spectrum file.");
+    }
+
+    if (m_header->version != VERSION) {
+        fail(filename + " has unsupported version " + std::to_string(m_header->version) + ".");
+    }
+
+    std::size_t entrySize = 0;
+    if (m_header->kind == Kind::Dense) {
+        entrySize = sizeof(CComplex);
+        if (m_header->count != m_header->size) fail(filename + " has an inconsistent header.");
+    } else if (m_header->kind == Kind::Sparse) {
+        entrySize = sizeof(Entry);
+        if (m_header->count > m_header->size) fail(filename + " has an inconsistent header.");
+    } else {
+        fail(filename + " has an unknown kind.");
+    }
+
+    // size() and count() are int, and count * entrySize must not wrap around
+    if (m_header->size < 0 || m_header->size > INT_MAX || m_header->count < 0 || m_header->count > INT_MAX) {
+        fail(filename + " has an inconsistent header.");
+    }
+
+    std::size_t payloadLength = m_length - sizeof(Header);
+    if (payloadLength % entrySize != 0 || static_cast<std::size_t>(m_header->count) != payloadLength / entrySize) {
+        fail(filename + " is truncated.");
+    }
+
+    if (verify && checksum(payload(), m_length - sizeof(Header)) != m_header->checksum) {
+        fail(filename + " is corrupted (checksum mismatch).");
+    }
+}
+
+CSpectrumFile::~CSpectrumFile() {
+    if (m_data) munmap(m_data, m_length);
+}
+
+const std::byte* CSpectrumFile::payload() const {
+    return static_cast<const std::byte*>(m_data) + sizeof(Header);
+}
+
+/*
+ * FNV-1a over 64 bit words, the payload is always a multiple of 8 bytes.
+*/
+std::uint64_t CSpectrumFile::checksum(const std::byte* data, std::size_t length) {
+    std::uint64_t hash = FNV_OFFSET;
+
+    for (std::size_t i = 0; i + 8 <= length; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+CSpectrumFile::Kind CSpectrumFile::kind() const {
+    return m_header->kind;
+}
+
+int CSpectrumFile::size() const {
+    return m_header->size;
+}
+
+int CSpectrumFile::count() const {
+    return m_header->count;
+}
+
+double CSpectrumFile::threshold() const {
+    return m_header->threshold;
+}
+
+std::span<const CComplex> CSpectrumFile::dense() const {
+    if (kind() != Kind::Dense) {
+        throw std::invalid_argument("Spectrum file is sparse.");
+    }
+
+    return std::span<const CComplex>(reinterpret_cast<const CComplex*>(payload()), count());
+}
+
+std::span<const CSpectrumFile::Entry> CSpectrumFile::entries() const {
+    if (kind() != Kind::Sparse) {
+        throw std::invalid_argument("Spectrum file is dense.");
+    }
+
+    return std::span<const Entry>(reinterpret_cast<const Entry*>(payload()), count());
+}
+
+std::vector<CComplex> CSpectrumFile::toVector() const {
+    if (kind() == Kind::Dense) {
+        return std::vector<CComplex>(dense().begin(), dense().end());
+    }
+
+    std::vector<CComplex> result(size());
+    for (const Entry& entry : entries()) {
+        if (entry.index < 0 || entry.index >= size()) {
+            throw std::out_of_range("Spectrum index out of range.");
+        }
+        result[entry.index] = entry.value;
+    }
+
+    return result;
+}
+
+CSparseSpectrum CSpectrumFile::toSparse() const {
+    if (kind() == Kind::Dense) {
+        return CSparseSpectrum(toVector());
+    }
+
+    CSparseSpectrum result(size());
+    for (const Entry& entry : entries()) {
+        result.add(entry.index, entry.value);
+    }
+
+    return result;
+}
+
+void CSpectrumFile::write(const std::string& filename, Kind kind, std::int64_t size, double threshold, const void* payload, std::size_t count, std::size_t entrySize) {
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.kind = kind;
+    header.size = size;
+    header.count = count;
+    header.threshold = threshold;
+    header.checksum = checksum(static_cast<const std::byte*>(payload), count * entrySize);
+
+    std::ofstream fp(filename, std::ios::binary);
+    fp.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    fp.write(static_cast<const char*>(payload), count * entrySize);
+    fp.close();
+
+    if (!fp) {
+        throw std::runtime_error("Cannot write " + filename + ".");
+    }
+}
+
+void CSpectrumFile::writeDense(const std::string& filename, std::span<const CComplex> values, double threshold) {
+    write(filename, Kind::Dense, values.size(), threshold, values.data(), values.size(), sizeof(CComplex));
+}
+
+void CSpectrumFile::writeSparse(const std::string& filename, const CSparseSpectrum& spectrum, double threshold) {
+    std::vector<Entry> entries(spectrum.nonZeros());
+    for (int i = 0; i < entries.size(); i++) {
+        entries[i] = {spectrum.index(i), spectrum.value(i)};
+    }
+
+    write(filename, Kind::Sparse, spectrum.size(), threshold, entries.data(), entries.size(), sizeof(Entry));
+}
+
+/*
+ * Keeps the values with |c| > epsilon like Helper::writeValues and picks
+ * the smaller of the two variants.
+*/
+void CSpectrumFile::write(const std::string& filename, const std::vector<CComplex>& values, double epsilon) {
+    CSparseSpectrum spectrum(values, epsilon);
+
+    if (spectrum.nonZeros() * sizeof(Entry) < values.size() * sizeof(CComplex)) {
+        writeSparse(filename, spectrum, epsilon);
+    } else if (epsilon < 0) {
+        writeDense(filename, values, epsilon);
+    } else {
+        writeDense(filename, spectrum.toDense(), epsilon);
+    }
+}
+
+/*
+ * Converts a file in the text format of Helper::writeValues, the entries
+ * are stored as they are listed.
+*/
+void CSpectrumFile::convertText(const std::string& textFile, const std::string& binaryFile, double threshold) {
+    CSparseSpectrum spectrum = Helper::readSparseValues(textFile);
+
+    if (spectrum.nonZeros() * sizeof(Entry) < spectrum.size() * sizeof(CComplex)) {
+        writeSparse(binaryFile, spectrum, threshold);
+    } else {
+        writeDense(binaryFile, spectrum.toDense(), threshold);
+    }
+}
@@ -0,0 +1,167 @@
+#include "../lib/CThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+    thread_local const CThreadPool* t_pool = nullptr;
+    thread_local int t_queue = -1;
+
+    std::mutex instanceMutex;
+    std::unique_ptr<CThreadPool> instancePtr;
+}
+
+/*
+ * threads counts the calling thread, so threads - 1 workers are started.
+ * The last queue takes the tasks of threads outside the pool.
+*/
+CThreadPool::CThreadPool(int threads) : m_pending(0), m_stop(false) {
+    threads = std::max(threads, 1);
+
+    for (int i = 0; i < threads; i++) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+
+    for (int i = 0; i < threads - 1; i++) {
+        m_threads.emplace_back(&CThreadPool::workerLoop, this, i);
+    }
+}
+
+CThreadPool::~CThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+CThreadPool& CThreadPool::instance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+
+    if (!instancePtr) {
+        instancePtr.reset(new CThreadPool(std::thread::hardware_concurrency()));
+    }
+
+    return *instancePtr;
+}
+
+/*
+ * Replaces the shared pool, must not be called while parallel work is running.
+*/
+void CThreadPool::setThreadCount(int threads) {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    instancePtr.reset();
+    instancePtr.reset(new CThreadPool(threads));
+}
+
+int CThreadPool::threadCount() const {
+    return m_queues.size();
+}
+
+int CThreadPool::currentQueue() const {
+    return t_pool == this ? t_queue : m_queues.size() - 1;
+}
+
+void CThreadPool::push(int queue, std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+        m_queues[queue]->tasks.push_back(std::move(task));
+    }
+
+    m_pending++;
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wake.notify_one();
+}
+
+bool CThreadPool::runOne(int queue) {
+    std::function<void()> task;
+    int n = m_queues.size();
+
+    for (int i = 0; i < n && !task; i++) {
+        Queue& current = *m_queues[(queue + i) % n];
+        std::lock_guard<std::mutex> lock(current.mutex);
+
+        if (current.tasks.empty()) continue;
+
+        if (i == 0) {
+            task = std::move(current.tasks.back());
+            current.tasks.pop_back();
+        } else {
+            task = std::move(current.tasks.front());
+            current.tasks.pop_front();
+        }
+    }
+
+    if (!task) return false;
+
+    m_pending--;
+    task();
+    return true;
+}
+
+void CThreadPool::workerLoop(int queue) {
+    t_pool = this;
+    t_queue = queue;
+
+    while (true) {
+        if (runOne(queue)) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] { return m_stop || m_pending > 0; });
+
+        if (m_stop && m_pending == 0) return;
+    }
+}
+
+/*
+ * Calls body(from, to) on chunks of at least grain indices covering
+ * [begin, end) and returns when all chunks are done. The first exception
+ * thrown by a chunk is rethrown here.
+*/
+void CThreadPool::parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body) {
+    if (end <= begin) return;
+
+    long long count = end - begin;
+    int chunks = std::min<long long>((count + std::max(grain, 1) - 1) / std::max(grain, 1), threadCount() * 4);
+
+    if (chunks <= 1 || threadCount() == 1) {
+        body(begin, end);
+        return;
+    }
+
+    std::atomic<int> remaining(chunks);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto runChunk = [&](int chunk) {
+        int from = begin + count * chunk / chunks;
+        int to = begin + count * (chunk + 1) / chunks;
+
+        try {
+            body(from, to);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+
+        remaining--;
+    };
+
+    int queue = currentQueue();
+    for (int chunk = chunks - 1; chunk > 0; chunk--) {
+        push(queue, [&runChunk, chunk] { runChunk(chunk); });
+    }
+
+    runChunk(0);
+
+    while (remaining > 0) {
+        if (!runOne(queue)) std::this_thread::yield();
+    }
+
+    if (error) std::rethrow_exception(error);
+}
@@ -2,6 +2,9 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include "../lib/CComplex.h"
 #include <cmath>
+#include <complex>
+#include <cstring>
+#include <vector>
 
 using namespace Catch::Matchers;
 
@@ -99,3 +102,19 @@ TEST_CASE("CComplex inequality operator", "[CComplex]") {
     REQUIRE(c1 != c2);
 }
 
+TEST_CASE("CComplex is a constexpr value type", "[CComplex]") {
+    constexpr CComplex c = CComplex(1, 2) * CComplex(3, 4) + CComplex(1, 0);
+    STATIC_REQUIRE(c.re() == -4);
+    STATIC_REQUIRE(c.im() == 10);
+    STATIC_REQUIRE(CComplex(3, 4).absSq() == 25);
+}
+
+TEST_CASE("CComplex has the layout of std::complex<double>", "[CComplex]") {
+    std::vector<std::complex<double>> values = {{1, 2}, {-3, 4}};
+    std::vector<CComplex> copy(values.size());
+
+    std::memcpy(static_cast<void*>(copy.data()), values.data(), values.size() * sizeof(CComplex));
+
+    REQUIRE(copy[0] == CComplex(1, 2));
+    REQUIRE(copy[1] == CComplex(-3, 4));
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include "../lib/CDGLSolver.h"
+#include "../lib/CMyMatrix.h"
+#include "../lib/CMyVector.h"
+
+using namespace Catch::Matchers;
+
+TEST_CASE("Vector expressions evaluate like the single operations", "[CExpression]") {
+    CMyVector a({1, 2, 3});
+    CMyVector b({0.5, -1, 4});
+    CMyVector c({2, 2, -2});
+
+    CMyVector result = a + b * 2.0 - 0.5 * c;
+    REQUIRE(result == CMyVector({1, -1, 12}));
+    REQUIRE((a * b) == CMyVector({0.5, -2, 12}));
+    REQUIRE(CMyVector(-a) == CMyVector({-1, -2, -3}));
+
+    // componentwise operations may overwrite an operand in place
+    CMyVector y = a;
+    y = y + b * 2.0 - y * 0.5;
+    REQUIRE(y == CMyVector({1.5, -1, 9.5}));
+
+    y += c;
+    y -= a * 2.0;
+    y *= 2;
+    REQUIRE(y == CMyVector({3, -6, 3}));
+
+    REQUIRE_THROWS_AS(a + CMyVector({1, 2}), std::invalid_argument);
+    REQUIRE_THROWS_AS(y += CMyVector({1, 2}), std::invalid_argument);
+}
+
+TEST_CASE("Matrix expressions and views as operands", "[CExpression]") {
+    CMyMatrix A({{1, 2}, {3, 4}});
+    CMyMatrix B({{2, 0}, {1, 2}});
+
+    CMyMatrix sum = A + B * 2.0 - (-A);
+    REQUIRE(sum.get(0, 0) == 6.0);
+    REQUIRE(sum.get(0, 1) == 4.0);
+    REQUIRE(sum.get(1, 0) == 8.0);
+    REQUIRE(sum.get(1, 1) == 12.0);
+
+    // the transpose reads A while A is assigned
+    A = A.transpose() + A;
+    REQUIRE(A.get(0, 1) == 5.0);
+    REQUIRE(A.get(1, 0) == 5.0);
+
+    CMyVector row = B.row(1) + B.column(0) * 2.0;
+    REQUIRE(row == CMyVector({5, 4}));
+
+    REQUIRE_THROWS_AS(CMyMatrix(A + CMyMatrix(2, 3)), std::invalid_argument);
+}
+
+TEST_CASE("Nodes own their temporary operands", "[CExpression]") {
+    // the temporaries are moved into the node, so it outlives the statement
+    auto node = CMyVector({1, 2}) * 2.0 + -CMyVector({1, 1});
+    CMyVector result = node;
+    REQUIRE(result == CMyVector({1, 3}));
+
+    auto matrix = CMyMatrix({{1, 2}, {3, 4}}) - CMyMatrix({{1, 1}, {1, 1}}) * 2.0;
+    CMyMatrix difference = matrix;
+    REQUIRE(difference.get(0, 0) == -1.0);
+    REQUIRE(difference.get(1, 1) == 2.0);
+
+    // a right hand side built from a local returns the vector type
+    auto f = [](const CMyVector& y, double) -> CMyVector {
+        CMyVector d = y;
+        d[0] = 1;
+        return d * 0.5;
+    };
+    CMyVector y = CDGLSolver<>::euler(f, 0.0, 1.0, 10, CMyVector({0.0, 2.0}));
+    REQUIRE_THAT(y.get(0), WithinAbs(0.5, 1e-12));
+    REQUIRE_THAT(y.get(1), WithinAbs(2 * std::pow(1.05, 10), 1e-12));
+}
+
+TEST_CASE("Fused vector update throughput", "[.][benchmark]") {
+    for (int n : {3, 1000}) {
+        CMyVector y(n), d(n), e(n);
+        for (int i = 0; i < n; i++) {
+            y[i] = i;
+            d[i] = 1.0 / (i + 1);
+            e[i] = 0.5 * i;
+        }
+
+        int repetitions = 20000000 / n;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repetitions; r++) {
+            y = y + d * 1e-6 + e * 1e-7 - d;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "n = " << n << ": " << seconds / repetitions * 1e9 << " ns per update" << std::endl;
+        REQUIRE(std::isfinite(y.get(n - 1)));
+    }
+}
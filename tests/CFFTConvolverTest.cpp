@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "../lib/CComplex.h"
+#include "../lib/CFFTConvolver.h"
+#include "../lib/Helper.h"
+
+using namespace Catch::Matchers;
+
+namespace {
+    std::vector<CComplex> convolve(const std::vector<CComplex>& signal, const std::vector<CComplex>& kernel) {
+        std::vector<CComplex> result(signal.size() + kernel.size() - 1);
+
+        for (int i = 0; i < signal.size(); i++) {
+            for (int j = 0; j < kernel.size(); j++) {
+                result[i + j] += signal[i] * kernel[j];
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<CComplex> runBlocks(CFFTConvolver& convolver, const std::vector<CComplex>& signal) {
+        std::vector<CComplex> result;
+
+        for (int from = 0; from < signal.size(); from += convolver.blockSize()) {
+            int to = std::min<int>(from + convolver.blockSize(), signal.size());
+            std::vector<CComplex> block = convolver.process(std::span<const CComplex>(signal.data() + from, to - from));
+            result.insert(result.end(), block.begin(), block.end());
+        }
+
+        std::vector<CComplex> tail = convolver.flush();
+        result.insert(result.end(), tail.begin(), tail.end());
+        return result;
+    }
+}
+
+TEST_CASE("Block convolution matches direct convolution", "[CFFTConvolver]") {
+    std::vector<CComplex> signal(1000);
+    for (int i = 0; i < signal.size(); i++) {
+        signal[i] = CComplex(std::sin(0.05 * i) + 0.1 * (i % 7), std::cos(0.02 * i));
+    }
+
+    for (int K : {1, 37, 150}) {
+        std::vector<CComplex> kernel(K);
+        for (int j = 0; j < K; j++) {
+            kernel[j] = CComplex(1.0 / (j + 1), 0.01 * j);
+        }
+
+        std::vector<CComplex> expected = convolve(signal, kernel);
+
+        for (auto method : {CFFTConvolver::Method::OverlapAdd, CFFTConvolver::Method::OverlapSave}) {
+            CFFTConvolver convolver(kernel, 64, method);
+            std::vector<CComplex> result = runBlocks(convolver, signal);
+
+            REQUIRE(result.size() == expected.size());
+            for (int i = 0; i < expected.size(); i++) {
+                REQUIRE_THAT(result[i].re(), WithinAbs(expected[i].re(), 1e-9));
+                REQUIRE_THAT(result[i].im(), WithinAbs(expected[i].im(), 1e-9));
+            }
+
+            // the state is reset by flush(), so a second run gives the same result
+            std::vector<CComplex> again = runBlocks(convolver, signal);
+            REQUIRE(Helper::maxDeviation(result, again) < 1e-12);
+        }
+    }
+
+    REQUIRE_THROWS_AS(CFFTConvolver(std::vector<CComplex>(), 64), std::invalid_argument);
+
+    CFFTConvolver convolver({CComplex(1, 0)}, 4);
+    REQUIRE_THROWS_AS(convolver.process(std::vector<CComplex>(5)), std::invalid_argument);
+}
+
+TEST_CASE("Streaming spectral filter", "[CFFTConvolver]") {
+    std::vector<CComplex> values = Helper::readValues("data/example1.txt");
+
+    SECTION("An empty threshold keeps the signal") {
+        std::ifstream in("data/example1.txt");
+        std::stringstream out;
+        CFFTConvolver::threshold(0, 128).process(in, out);
+
+        std::vector<CComplex> result;
+        int N, idx;
+        double re, im;
+        out >> N;
+        while (out >> idx >> re >> im) {
+            REQUIRE(idx == result.size());
+            result.emplace_back(re, im);
+        }
+
+        REQUIRE(N == values.size());
+        REQUIRE(Helper::maxDeviation(values, result) < 1e-9);
+    }
+
+    SECTION("Missing indices are zero") {
+        std::stringstream in("6\n1 2 0\n4 -1 0.5\n");
+        std::stringstream out;
+        CFFTConvolver({CComplex(1, 0)}, 4, CFFTConvolver::Method::OverlapSave).process(in, out);
+        REQUIRE(out.precision() == 6);
+
+        int N, idx;
+        double re, im;
+        out >> N;
+        REQUIRE(N == 6);
+
+        std::vector<CComplex> expected = {CComplex(0, 0), CComplex(2, 0), CComplex(0, 0), CComplex(0, 0), CComplex(-1, 0.5), CComplex(0, 0)};
+        for (const CComplex& c : expected) {
+            REQUIRE(out >> idx >> re >> im);
+            REQUIRE_THAT(re, WithinAbs(c.re(), 1e-12));
+            REQUIRE_THAT(im, WithinAbs(c.im(), 1e-12));
+        }
+    }
+}
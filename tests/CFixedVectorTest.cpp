@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include "../lib/CDGLSolver.h"
+#include "../lib/CFixedMatrix.h"
+#include "../lib/CFixedVector.h"
+
+using namespace Catch::Matchers;
+
+namespace {
+    constexpr CFixedMatrix<3, 3> A = {{2, 1, 0}, {1, 3, 1}, {0, 1, 4}};
+
+    // everything but magnitude() is usable in constant expressions
+    static_assert(CFixedVector<2>({1, 2}) + CFixedVector<2>({3, 4}) * 2.0 == CFixedVector<2>({7, 10}));
+    static_assert(CFixedVector<3>({1, 2, 3}).dot({4, 5, 6}) == 32);
+    static_assert(CFixedMatrix<2, 2>({{4, 7}, {2, 6}}).determinant() == 10);
+    static_assert((A * A.inverse()).get(1, 1) > 0.999999);
+
+    template<typename V>
+    double nthOrder(V y, double x) {
+        return 2 * x * y.get(1) * y.get(2) + 2 * y.get(0) * y.get(0) * y.get(1);
+    }
+}
+
+TEST_CASE("Fixed vectors behave like CMyVector", "[CFixedVector]") {
+    CFixedVector<3> a({1, 2, 3});
+    CFixedVector<3> b({0.5, -1, 4});
+
+    REQUIRE((a - b * 2.0) == CFixedVector<3>({0, 4, -5}));
+    REQUIRE((-a) == CFixedVector<3>({-1, -2, -3}));
+    REQUIRE((a * b) == CFixedVector<3>({0.5, -2, 12}));
+    REQUIRE(a.magnitude() == CMyVector({1, 2, 3}).magnitude());
+    REQUIRE(a.to_string() == CMyVector({1, 2, 3}).to_string());
+
+    CMyVector dynamic = a;
+    REQUIRE(CFixedVector<3>(dynamic) == a);
+
+    REQUIRE_THROWS_AS(CFixedVector<3>(2), std::invalid_argument);
+    REQUIRE_THROWS_AS(CFixedVector<2>({1, 2, 3}), std::invalid_argument);
+    REQUIRE_THROWS_AS(a[3], std::out_of_range);
+}
+
+TEST_CASE("Fixed matrices solve and invert like CMyMatrix", "[CFixedVector]") {
+    CMyMatrix dynamic = A;
+    CFixedVector<3> b({1, 2, 3});
+    CFixedVector<3> x = A.solve(b);
+    CMyVector expected = dynamic.lu().solve(b);
+
+    for (int i = 0; i < 3; i++) {
+        REQUIRE_THAT(x.get(i), WithinAbs(expected.get(i), 1e-15));
+    }
+
+    REQUIRE_THAT(A.determinant(), WithinAbs(dynamic.determinant(), 1e-12));
+    REQUIRE(A.transpose().get(0, 1) == 1.0);
+
+    CFixedMatrix<2, 3> B = {{1, 2, 3}, {4, 5, 6}};
+    CFixedMatrix<3, 2> C = {{1, 2}, {3, 4}, {5, 6}};
+    REQUIRE((B * C).get(1, 1) == 64.0);
+
+    CFixedMatrix<2, 2> singular = {{1, 2}, {2, 4}};
+    REQUIRE_THROWS_AS(singular.inverse(), std::invalid_argument);
+}
+
+TEST_CASE("Solvers accept fixed vectors", "[CFixedVector]") {
+    SECTION("Newton") {
+        auto f = [](CFixedVector<2> v) {
+            return CFixedVector<2>({std::pow(v.get(0), 3) * std::pow(v.get(1), 3) - 2 * v.get(1), v.get(0) - 2});
+        };
+
+        CFixedVector<2> result = CFixedMatrix<2, 2>::newton({1.0, 1.0}, f);
+        REQUIRE_THAT(result.get(0), WithinAbs(2.0, 0.0001));
+        REQUIRE_THAT(result.get(1), WithinAbs(-0.5, 0.0001));
+    }
+
+    SECTION("Heun gives the same result for both vector types") {
+        CDGLSolver<CFixedVector<3>> fixed(nthOrder<CFixedVector<3>>);
+        CDGLSolver dynamic(nthOrder<CMyVector>);
+
+        CFixedVector<3> y = fixed.heun(1.0, 2.0, 1000, {1.0, -1.0, 2.0});
+        CMyVector expected = dynamic.heun(1.0, 2.0, 1000, CMyVector({1.0, -1.0, 2.0}));
+
+        REQUIRE(CMyVector(y) == expected);
+        REQUIRE_THAT(y.get(0), WithinAbs(0.5, 1e-5));
+    }
+
+    SECTION("Dormand-Prince gives the same result for both vector types") {
+        CFixedVector<3> y = CDGLSolver<CFixedVector<3>>::dormandPrince(nthOrder<CFixedVector<3>>, 1.0, 2.0, {1.0, -1.0, 2.0});
+        CMyVector expected = CDGLSolver<>::dormandPrince(nthOrder<CMyVector>, 1.0, 2.0, CMyVector({1.0, -1.0, 2.0}));
+
+        REQUIRE(CMyVector(y) == expected);
+        REQUIRE_THAT(y.get(0), WithinAbs(0.5, 1e-7));
+    }
+
+    SECTION("Minimize") {
+        auto f = [](auto x) {
+            return std::pow(x.get(0) - 1, 2) + 2 * std::pow(x.get(1) + 0.5, 2);
+        };
+
+        CFixedVector<2> fixed = CMyVector::minimize(CFixedVector<2>({0, 0}), f, 0.1);
+        CMyVector dynamic = CMyVector::minimize(CMyVector({0, 0}), f, 0.1);
+
+        REQUIRE(CMyVector(fixed) == dynamic);
+        REQUIRE_THAT(fixed.get(0), WithinAbs(1, 1e-4));
+        REQUIRE_THAT(fixed.get(1), WithinAbs(-0.5, 1e-4));
+    }
+}
+
+TEST_CASE("Heun steps with fixed and dynamic vectors", "[.][benchmark]") {
+    CDGLSolver<CFixedVector<3>> fixed(nthOrder<CFixedVector<3>>);
+    CDGLSolver dynamic(nthOrder<CMyVector>);
+    int steps = 1000000;
+
+    auto start = std::chrono::steady_clock::now();
+    CMyVector a = dynamic.heun(1.0, 2.0, steps, CMyVector({1.0, -1.0, 2.0}));
+    double dynamicSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    CFixedVector<3> b = fixed.heun(1.0, 2.0, steps, {1.0, -1.0, 2.0});
+    double fixedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "CMyVector: " << dynamicSeconds / steps * 1e9 << " ns per step" << std::endl;
+    std::cout << "CFixedVector<3>: " << fixedSeconds / steps * 1e9 << " ns per step" << std::endl;
+    REQUIRE(CMyVector(b) == a);
+}
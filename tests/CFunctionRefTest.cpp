@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "../lib/CDGLSolver.h"
+#include "../lib/CFunctionRef.h"
+#include "../lib/CMyVector.h"
+
+using namespace Catch::Matchers;
+
+namespace {
+    double square(double x) {
+        return x * x;
+    }
+
+    double apply(CFunctionRef<double(double)> f, double x) {
+        return f(x);
+    }
+
+    double nthOrder(const CMyVector& y, double x) {
+        return 2 * x * y.get(1) * y.get(2) + 2 * y.get(0) * y.get(0) * y.get(1);
+    }
+}
+
+TEST_CASE("CFunctionRef calls functions and lambdas", "[CFunctionRef]") {
+    REQUIRE(apply(square, 3) == 9);
+    REQUIRE(apply(&square, 4) == 16);
+    REQUIRE(apply([](double x) { return x + 1; }, 1) == 2);
+
+    // the lambda is referenced, not copied
+    int calls = 0;
+    auto counted = [&calls](double x) {
+        calls++;
+        return x;
+    };
+    CFunctionRef<double(double)> ref = counted;
+    ref(1);
+    ref(2);
+    REQUIRE(calls == 2);
+
+    // the result may be converted, like std::function does
+    REQUIRE(apply([](double x) { return static_cast<int>(x); }, 2.5) == 2);
+}
+
+TEST_CASE("Solvers accept any callable", "[CFunctionRef]") {
+    auto f = [](const CMyVector& x) {
+        return std::pow(x.get(0) - 1, 2) + 2 * std::pow(x.get(1) + 0.5, 2);
+    };
+
+    CMyVector templated = CMyVector::minimize(CMyVector({0, 0}), f, 0.1);
+    CMyVector referenced = CMyVector::minimize(CMyVector({0, 0}), CFunctionRef<double(const CMyVector&)>(f), 0.1);
+    REQUIRE(templated == referenced);
+    REQUIRE_THAT(templated.get(0), WithinAbs(1, 1e-4));
+
+    CDGLSolver solver(nthOrder);
+    CMyVector stored = solver.heun(1.0, 2.0, 1000, CMyVector({1.0, -1.0, 2.0}));
+    CMyVector inlined = CDGLSolver<>::heun(nthOrder, 1.0, 2.0, 1000, CMyVector({1.0, -1.0, 2.0}));
+    REQUIRE(stored == inlined);
+    REQUIRE_THAT(inlined.get(0), WithinAbs(0.5, 1e-5));
+}
+
+TEST_CASE("Heun steps with a stored and an inlined right hand side", "[.][benchmark]") {
+    CDGLSolver solver(nthOrder);
+    auto f = [](const CMyVector& y, double x) { return nthOrder(y, x); };
+    int steps = 1000000;
+
+    auto start = std::chrono::steady_clock::now();
+    CMyVector a = solver.heun(1.0, 2.0, steps, CMyVector({1.0, -1.0, 2.0}));
+    double storedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    CMyVector b = CDGLSolver<>::heun(f, 1.0, 2.0, steps, CMyVector({1.0, -1.0, 2.0}));
+    double inlinedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "std::function: " << storedSeconds / steps * 1e9 << " ns per step" << std::endl;
+    std::cout << "template: " << inlinedSeconds / steps * 1e9 << " ns per step" << std::endl;
+    REQUIRE(a == b);
+}
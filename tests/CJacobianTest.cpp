@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include "../lib/CJacobian.h"
+
+using namespace Catch::Matchers;
+
+namespace {
+    // f(x) = (x0^2 * x1, x0 + 3 x1 x2, x2^3), written once for both argument types
+    template<typename T>
+    std::vector<T> sample(const std::vector<T>& x) {
+        return {x[0] * x[0] * x[1], x[0] + x[1] * x[2] * 3.0, x[2] * x[2] * x[2]};
+    }
+
+    CMyMatrix sampleJacobian(const std::vector<double>& x) {
+        return CMyMatrix({{2 * x[0] * x[1], x[0] * x[0], 0},
+                          {1, 3 * x[2], 3 * x[1]},
+                          {0, 0, 3 * x[2] * x[2]}});
+    }
+
+    CMyVector realSample(const CMyVector& x) {
+        std::vector<double> values = sample<double>({x.get(0), x.get(1), x.get(2)});
+        return CMyVector(values);
+    }
+}
+
+TEST_CASE("Jacobian differences and their cost", "[CJacobian]") {
+    std::vector<double> point = {1.5, -0.5, 2.0};
+    CMyVector x({1.5, -0.5, 2.0});
+    CMyMatrix expected = sampleJacobian(point);
+
+    std::atomic<int> evaluations = 0;
+    auto counted = [&evaluations](const CMyVector& v) {
+        evaluations++;
+        return realSample(v);
+    };
+
+    for (bool parallel : {false, true}) {
+        evaluations = 0;
+        CMyMatrix forward = CJacobian::compute(x, counted, 1e-6, CJacobian::Difference::Forward, parallel);
+        REQUIRE(evaluations == 4);
+
+        evaluations = 0;
+        CMyMatrix central = CJacobian::compute(x, counted, 1e-4, CJacobian::Difference::Central, parallel);
+        REQUIRE(evaluations == 6);
+
+        CMyMatrix complex = CJacobian::complexStep(point, sample<CComplex>, 1e-20, parallel);
+
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                REQUIRE_THAT(forward.get(i, j), WithinAbs(expected.get(i, j), 1e-4));
+                REQUIRE_THAT(central.get(i, j), WithinAbs(expected.get(i, j), 1e-7));
+                REQUIRE_THAT(complex.get(i, j), WithinAbs(expected.get(i, j), 1e-14));
+            }
+        }
+    }
+
+    // CMyMatrix::jacobi uses forward differences
+    evaluations = 0;
+    CMyMatrix jacobi = CMyMatrix::jacobi(x, counted);
+    REQUIRE(evaluations == 4);
+}
+
+TEST_CASE("Gradient evaluates f(x) once", "[CJacobian]") {
+    int evaluations = 0;
+    auto f = [&evaluations](CMyVector v) {
+        evaluations++;
+        return v.get(0) * v.get(0) + 3 * v.get(1) - v.get(2) * v.get(3);
+    };
+
+    CMyVector gradient = CMyVector::gradient(CMyVector({1, 2, 3, 4}), f, 1e-6);
+    REQUIRE(evaluations == 5);
+    REQUIRE_THAT(gradient.get(0), WithinAbs(2, 1e-4));
+    REQUIRE_THAT(gradient.get(1), WithinAbs(3, 1e-4));
+    REQUIRE_THAT(gradient.get(2), WithinAbs(-4, 1e-4));
+    REQUIRE_THAT(gradient.get(3), WithinAbs(-3, 1e-4));
+}
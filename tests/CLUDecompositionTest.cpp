@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <stdexcept>
+#include "../lib/CLUDecomposition.h"
+#include "../lib/CMyMatrix.h"
+
+using namespace Catch::Matchers;
+
+namespace {
+    CMyMatrix sampleMatrix(int n) {
+        CMyMatrix result(n, n);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                result.set(i, j, std::sin(0.7 * i + 1.3 * j) + (i == j ? 2.0 : 0.0));
+            }
+        }
+
+        return result;
+    }
+
+    double cofactorDeterminant(const CMyMatrix& matrix) {
+        auto [n, m] = matrix.dimensions();
+        if (n == 1) return matrix.get(0, 0);
+
+        double result = 0;
+        for (int i = 0; i < n; i++) {
+            CMyMatrix minor(n - 1, n - 1);
+            for (int j = 1; j < n; j++) {
+                for (int k = 0, l = 0; k < n; k++) {
+                    if (k != i) minor.set(j - 1, l++, matrix.get(j, k));
+                }
+            }
+            result += (i % 2 == 0 ? 1 : -1) * matrix.get(0, i) * cofactorDeterminant(minor);
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("LU determinant matches the cofactor expansion", "[CLUDecomposition]") {
+    for (int n = 1; n <= 6; n++) {
+        CMyMatrix A = sampleMatrix(n);
+        double expected = cofactorDeterminant(A);
+        REQUIRE_THAT(A.determinant(), WithinAbs(expected, 1e-10 * std::max(1.0, std::abs(expected))));
+    }
+
+    // a zero leading entry needs a row exchange, which flips the sign
+    CMyMatrix P({{0, 1, 0}, {1, 0, 0}, {0, 0, 3}});
+    REQUIRE(P.determinant() == -3.0);
+
+    CMyMatrix singular({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+    REQUIRE(singular.lu().singular());
+    REQUIRE_THAT(singular.determinant(), WithinAbs(0.0, 1e-12));
+}
+
+TEST_CASE("LU solves single and multiple right-hand sides", "[CLUDecomposition]") {
+    int n = 40;
+    CMyMatrix A = sampleMatrix(n);
+    CLUDecomposition lu = A.lu();
+
+    CMyVector x(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = std::cos(0.3 * i);
+    }
+
+    CMyVector solution = lu.solve(A * x);
+    for (int i = 0; i < n; i++) {
+        REQUIRE_THAT(solution.get(i), WithinAbs(x.get(i), 1e-10));
+    }
+
+    CMyMatrix X(n, 3);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 3; j++) {
+            X.set(i, j, std::sin(0.2 * i * (j + 1)));
+        }
+    }
+
+    CMyMatrix solutions = lu.solve(A * X);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 3; j++) {
+            REQUIRE_THAT(solutions.get(i, j), WithinAbs(X.get(i, j), 1e-10));
+        }
+    }
+
+    REQUIRE_THROWS_AS(lu.solve(CMyVector(n + 1)), std::invalid_argument);
+    REQUIRE_THROWS_AS(CLUDecomposition(CMyMatrix(2, 3)), std::invalid_argument);
+}
+
+TEST_CASE("LU inverse of an n x n matrix", "[CLUDecomposition]") {
+    int n = 25;
+    CMyMatrix A = sampleMatrix(n);
+    CMyMatrix product = A * A.inverse();
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            REQUIRE_THAT(product.get(i, j), WithinAbs(i == j ? 1.0 : 0.0, 1e-10));
+        }
+    }
+
+    CMyMatrix singular({{1, 2, 3}, {2, 4, 6}, {0, 1, 1}});
+    REQUIRE_THROWS_AS(singular.inverse(), std::invalid_argument);
+    REQUIRE_THROWS_AS(singular.lu().solve(CMyVector({1, 2, 3})), std::invalid_argument);
+}
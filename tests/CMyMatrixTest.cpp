@@ -1,6 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include "../lib/CGemm.h"
 #include "../lib/CMyMatrix.h"
 
 using namespace Catch::Matchers;
@@ -194,3 +199,147 @@ TEST_CASE("Newton method", "[CMyMatrix]")  {
 }
 
 
+
+TEST_CASE("Matrix views share the matrix storage", "[CMyMatrix]") {
+    CMyMatrix A({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+
+    SECTION("Rows and columns") {
+        CVectorView row = A.row(1);
+        CVectorView column = A.column(2);
+
+        REQUIRE(row.dimension() == 3);
+        REQUIRE(row.stride() == 1);
+        REQUIRE(column.stride() == 3);
+        REQUIRE(row.data() == A.data() + 3);
+        REQUIRE(CMyVector(row) == CMyVector({4, 5, 6}));
+        REQUIRE(CMyVector(column) == CMyVector({3, 6, 9}));
+
+        A.set(1, 2, 10);
+        REQUIRE(row.get(2) == 10.0);
+        REQUIRE(column.get(1) == 10.0);
+        REQUIRE_THROWS_AS(row.get(3), std::out_of_range);
+    }
+
+    SECTION("Transpose and submatrix") {
+        CMatrixView transposed = A.transpose();
+        CMatrixView lower = A.submatrix(1, 1, 2, 2);
+
+        REQUIRE(transposed.data() == A.data());
+        REQUIRE(transposed.get(0, 2) == 7.0);
+        REQUIRE(lower.dimensions() == std::make_tuple(2, 2));
+        REQUIRE(lower.get(1, 0) == 8.0);
+        REQUIRE(lower.transpose().get(1, 0) == 6.0);
+        REQUIRE(CMyVector(lower.column(1)) == CMyVector({6, 9}));
+
+        CMyMatrix copy = transposed;
+        A.set(2, 0, 0);
+        REQUIRE(transposed.get(0, 2) == 0.0);
+        REQUIRE(copy.get(0, 2) == 7.0);
+
+        REQUIRE_THROWS_AS(A.submatrix(2, 2, 2, 1), std::out_of_range);
+    }
+
+    SECTION("Storage is aligned and contiguous") {
+        CMyMatrix B(5, 7);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(B.data()) % 64 == 0);
+        REQUIRE(&B.row(4).data()[6] == B.data() + 34);
+        REQUIRE((B * CMyMatrix(7, 2)).dimensions() == std::make_tuple(5, 2));
+        REQUIRE_THROWS_AS(CMyMatrix({{1, 2}, {3}}), std::invalid_argument);
+        REQUIRE_THROWS_AS(CMyMatrix(-1, 5), std::invalid_argument);
+    }
+
+    SECTION("Temporaries return copies") {
+        auto transposed = (A * A).transpose();
+        auto row = CMyMatrix(A).row(1);
+        auto lower = CMyMatrix(A).submatrix(1, 1, 2, 2);
+
+        static_assert(std::is_same_v<decltype(transposed), CMyMatrix>);
+        static_assert(std::is_same_v<decltype(row), CMyVector>);
+        REQUIRE(transposed.get(0, 1) == (A * A).get(1, 0));
+        REQUIRE(row == CMyVector({4, 5, 6}));
+        REQUIRE(lower.get(1, 1) == 9.0);
+    }
+}
+
+namespace {
+    CMyMatrix sampleMatrix(int rows, int columns, double seed) {
+        CMyMatrix result(rows, columns);
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < columns; j++) {
+                result.set(i, j, std::sin(seed * (i + 1) + 0.37 * j));
+            }
+        }
+
+        return result;
+    }
+
+    CMyMatrix naiveProduct(const CMatrixView& a, const CMatrixView& b) {
+        auto [m, k] = a.dimensions();
+        auto [bk, n] = b.dimensions();
+        CMyMatrix result(m, n);
+
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) {
+                double sum = 0;
+                for (int p = 0; p < k; p++) {
+                    sum += a.get(i, p) * b.get(p, j);
+                }
+                result.set(i, j, sum);
+            }
+        }
+
+        return result;
+    }
+
+    double maxDifference(const CMyMatrix& a, const CMyMatrix& b) {
+        auto [rows, columns] = a.dimensions();
+        double result = 0;
+
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < columns; j++) {
+                result = std::max(result, std::abs(a.get(i, j) - b.get(i, j)));
+            }
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("Blocked matrix product matches the definition", "[CMyMatrix]") {
+    for (auto [m, k, n] : {std::make_tuple(1, 1, 1), std::make_tuple(7, 5, 3), std::make_tuple(67, 131, 45),
+                           std::make_tuple(125, 300, 17), std::make_tuple(13, 260, 2051)}) {
+        CMyMatrix A = sampleMatrix(m, k, 0.11);
+        CMyMatrix B = sampleMatrix(k, n, 0.07);
+
+        REQUIRE(maxDifference(A * B, naiveProduct(A.view(), B.view())) < 1e-10 * k);
+    }
+
+    // strided operands are packed like contiguous ones
+    CMyMatrix A = sampleMatrix(90, 70, 0.3);
+    CMyMatrix B = sampleMatrix(90, 50, 0.2);
+    CMyMatrix product(70, 50);
+    CGemm::multiply(A.transpose(), B.view(), product.data(), 50);
+
+    REQUIRE(maxDifference(product, naiveProduct(A.transpose(), B.view())) < 1e-9);
+}
+
+TEST_CASE("Matrix product throughput", "[.][benchmark]") {
+    std::cout << "GEMM micro-kernel: " << (CGemm::usesSimd() ? "AVX2 FMA" : "scalar") << std::endl;
+
+    for (int n : {2, 3, 64, 256, 512, 1024}) {
+        CMyMatrix A = sampleMatrix(n, n, 0.1);
+        CMyMatrix B = sampleMatrix(n, n, 0.2);
+        int repetitions = std::max(1, (1 << 27) / (n * n * n));
+
+        auto start = std::chrono::steady_clock::now();
+        double checksum = 0;
+        for (int r = 0; r < repetitions; r++) {
+            checksum += (A * B).get(n - 1, n - 1);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double gflops = 2.0 * n * n * n * repetitions / seconds * 1e-9;
+        std::cout << n << "x" << n << ": " << gflops << " GFLOP/s" << std::endl;
+        REQUIRE(std::isfinite(checksum));
+    }
+}
@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include "../lib/CNewtonSolver.h"
+
+using namespace Catch::Matchers;
+
+namespace {
+    // Broyden's tridiagonal problem, its Jacobian is tridiagonal
+    CMyVector tridiagonal(CMyVector x) {
+        int n = x.dimension();
+        CMyVector result(n);
+
+        for (int i = 0; i < n; i++) {
+            double left = i > 0 ? x.get(i - 1) : 0;
+            double right = i < n - 1 ? x.get(i + 1) : 0;
+            result[i] = (3 - 2 * x.get(i)) * x.get(i) - left - 2 * right + 1;
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("Newton solver methods find the same root", "[CNewtonSolver]") {
+    int n = 30;
+    CMyVector start(n);
+    for (int i = 0; i < n; i++) {
+        start[i] = -1;
+    }
+
+    CNewtonSolver newton(tridiagonal);
+    newton.setTolerance(1e-10, 50);
+    CNewtonSolver::Result reference = newton.solve(start);
+    REQUIRE(reference.converged);
+
+    for (auto [method, reuse] : {std::make_pair(CNewtonSolver::Method::Shamanskii, 3),
+                                 std::make_pair(CNewtonSolver::Method::Shamanskii, 1000),
+                                 std::make_pair(CNewtonSolver::Method::Broyden, 1)}) {
+        CNewtonSolver solver(tridiagonal, method, reuse);
+        solver.setTolerance(1e-10, 100);
+        CNewtonSolver::Result result = solver.solve(start);
+
+        std::cout << "method " << (int)method << " reuse " << reuse << ": " << result.iterations << " steps, "
+                  << result.jacobians << " Jacobians, " << result.evaluations << " evaluations (Newton "
+                  << reference.iterations << " / " << reference.jacobians << " / " << reference.evaluations << ")" << std::endl;
+
+        REQUIRE(result.converged);
+        REQUIRE(result.jacobians < reference.jacobians);
+        REQUIRE(result.evaluations < reference.evaluations);
+        for (int i = 0; i < n; i++) {
+            REQUIRE_THAT(result.x.get(i), WithinAbs(reference.x.get(i), 1e-8));
+        }
+    }
+
+    REQUIRE_THROWS_AS(CNewtonSolver(tridiagonal, CNewtonSolver::Method::Shamanskii, 0), std::invalid_argument);
+}
+
+TEST_CASE("Newton solver with analytic Jacobian and custom linear solver", "[CNewtonSolver]") {
+    int n = 10;
+    CMyVector start(n);
+    for (int i = 0; i < n; i++) {
+        start[i] = -1;
+    }
+
+    // solves the tridiagonal systems with the Thomas algorithm
+    int factorizations = 0;
+    CNewtonSolver solver(tridiagonal);
+    solver.setJacobian([n](CMyVector x) {
+        CMyMatrix result(n, n);
+        for (int i = 0; i < n; i++) {
+            result.set(i, i, 3 - 4 * x.get(i));
+            if (i > 0) result.set(i, i - 1, -1);
+            if (i < n - 1) result.set(i, i + 1, -2);
+        }
+
+        return result;
+    });
+    solver.setLinearSolver([n, &factorizations](const CMyMatrix& jacobian) -> CNewtonSolver::Factorization {
+        factorizations++;
+        return [n, jacobian](const CMyVector& b) {
+            std::vector<double> c(n), d(n);
+            for (int i = 0; i < n; i++) {
+                double lower = i > 0 ? jacobian.get(i, i - 1) : 0;
+                double upper = i < n - 1 ? jacobian.get(i, i + 1) : 0;
+                double denominator = jacobian.get(i, i) - (i > 0 ? lower * c[i - 1] : 0);
+                c[i] = upper / denominator;
+                d[i] = (b.get(i) - (i > 0 ? lower * d[i - 1] : 0)) / denominator;
+            }
+
+            CMyVector x(n);
+            for (int i = n - 1; i >= 0; i--) {
+                x[i] = d[i] - (i < n - 1 ? c[i] * x.get(i + 1) : 0);
+            }
+
+            return x;
+        };
+    });
+    solver.setTolerance(1e-12, 50);
+
+    CNewtonSolver::Result result = solver.solve(start);
+    REQUIRE(result.converged);
+    REQUIRE(factorizations == result.jacobians);
+    // with an analytic Jacobian every step evaluates f once
+    REQUIRE(result.evaluations == result.iterations + 1);
+    REQUIRE(tridiagonal(result.x).magnitude() < 1e-12);
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "../lib/CComplex.h"
+#include "../lib/CSTFT.h"
+#include "../lib/CSlidingDFT.h"
+#include "../lib/Helper.h"
+
+using namespace Catch::Matchers;
+
+namespace {
+    std::vector<CComplex> chirp(int length) {
+        std::vector<CComplex> values(length);
+        for (int i = 0; i < length; i++) {
+            values[i] = CComplex(std::sin(0.001 * i * i) + 0.2 * std::cos(0.3 * i), 0.1 * std::sin(0.7 * i));
+        }
+
+        return values;
+    }
+}
+
+TEST_CASE("STFT frames are windowed DFTs", "[CSTFT]") {
+    std::vector<CComplex> values = chirp(1000);
+
+    for (auto window : {CSTFT::Window::Rectangular, CSTFT::Window::Hann, CSTFT::Window::Hamming}) {
+        CSTFT stft(100, 30, window);
+        std::vector<double> weights = CSTFT::weights(window, 100);
+        std::vector<std::vector<CComplex>> spectrogram = stft.spectrogram(values);
+
+        REQUIRE(stft.frameCount(1000) == 31);
+        REQUIRE(spectrogram.size() == 31);
+
+        for (int f = 0; f < spectrogram.size(); f++) {
+            std::vector<CComplex> frame(100);
+            for (int n = 0; n < 100; n++) {
+                frame[n] = values[f * 30 + n] * weights[n];
+            }
+
+            REQUIRE(Helper::maxDeviation(spectrogram[f], CComplex::dft(frame)) < 1e-10);
+            REQUIRE(Helper::maxDeviation(spectrogram[f], stft.frame(values, f * 30)) < 1e-12);
+        }
+    }
+
+    REQUIRE(CSTFT(64, 8).frameCount(63) == 0);
+    REQUIRE_THROWS_AS(CSTFT(64, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(CSTFT(64, 8).frame(values, 950), std::out_of_range);
+}
+
+TEST_CASE("Sliding DFT follows the STFT with hop 1", "[CSTFT]") {
+    const int N = 32;
+    std::vector<CComplex> values = chirp(20 * N + 7);
+
+    for (auto window : {CSTFT::Window::Rectangular, CSTFT::Window::Hann, CSTFT::Window::Hamming}) {
+        CSlidingDFT sliding(N, window);
+        CSTFT stft(N, 1, window);
+
+        for (int i = 0; i < values.size(); i++) {
+            sliding.push(values[i]);
+
+            // passes the exact recomputation after 16 windows
+            if (i + 1 >= N) {
+                REQUIRE(Helper::maxDeviation(sliding.spectrum(), stft.frame(values, i + 1 - N)) < 1e-10);
+            }
+        }
+
+        sliding.reset();
+        sliding.push(std::span<const CComplex>(values.data(), N));
+        std::vector<CComplex> first = stft.frame(values, 0);
+        REQUIRE_THAT(sliding.bin(3).re(), WithinAbs(first[3].re(), 1e-12));
+        REQUIRE_THAT(sliding.bin(3).im(), WithinAbs(first[3].im(), 1e-12));
+    }
+
+    REQUIRE_THROWS_AS(CSlidingDFT(N).bin(N), std::out_of_range);
+}
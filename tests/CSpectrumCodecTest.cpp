@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "../lib/CComplex.h"
+#include "../lib/CSpectrumCodec.h"
+#include "../lib/Helper.h"
+
+using namespace Catch::Matchers;
+
+TEST_CASE("Compressed spectra decode within half a step", "[CSpectrumCodec]") {
+    std::vector<CComplex> values = Helper::readValues("data/example1.txt");
+    std::vector<CComplex> spectrum = CComplex::fft(values);
+
+    for (double epsilon : {-1.0, 0.1, 1.0}) {
+        for (double step : {1e-9, 1e-4, 0.01}) {
+            CSpectrumCodec codec(epsilon, step);
+            std::vector<CComplex> decoded = CSpectrumCodec::decode(codec.encode(spectrum));
+
+            REQUIRE(decoded.size() == spectrum.size());
+            for (int k = 0; k < spectrum.size(); k++) {
+                if (spectrum[k].abs() > epsilon) {
+                    REQUIRE_THAT(decoded[k].re(), WithinAbs(spectrum[k].re(), step / 2 * (1 + 1e-9)));
+                    REQUIRE_THAT(decoded[k].im(), WithinAbs(spectrum[k].im(), step / 2 * (1 + 1e-9)));
+                } else {
+                    REQUIRE(decoded[k] == CComplex(0, 0));
+                }
+            }
+        }
+    }
+
+    // the scratch file goes to the temporary directory, not into data/
+    std::string filename = (std::filesystem::temp_directory_path() / "example1_dft_01.cspc").string();
+    CSpectrumCodec(0.1, 1e-6).write(filename, spectrum);
+    std::vector<CComplex> read = CSpectrumCodec::read(filename);
+    REQUIRE(Helper::maxDeviation(read, CSpectrumCodec::decode(CSpectrumCodec(0.1, 1e-6).encode(spectrum))) == 0);
+    std::filesystem::remove(filename);
+
+    REQUIRE(CSpectrumCodec::decode(CSpectrumCodec().encode({})).empty());
+    REQUIRE_THROWS_AS(CSpectrumCodec(0, 0), std::invalid_argument);
+}
+
+TEST_CASE("Damaged compressed spectra are rejected", "[CSpectrumCodec]") {
+    std::vector<CComplex> spectrum = CComplex::fft(Helper::readValues("data/example2.txt"));
+    std::vector<std::uint8_t> data = CSpectrumCodec(-1, 1e-6).encode(spectrum);
+
+    REQUIRE_THROWS_AS(CSpectrumCodec::decode(std::vector<std::uint8_t>(data.begin(), data.begin() + data.size() / 2)), std::invalid_argument);
+
+    data[0] = 'X';
+    REQUIRE_THROWS_AS(CSpectrumCodec::decode(data), std::invalid_argument);
+
+    // one entry, but the first rANS stream claims 2^40 symbols of a single-symbol table
+    std::vector<std::uint8_t> huge = {
+        'C', 'S', 'P', 'C', 1, 1, 1,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20, 1, 0, 0x80, 0x20, 4, 0, 0x80, 0, 0
+    };
+    REQUIRE_THROWS_AS(CSpectrumCodec::decode(huge), std::invalid_argument);
+}
+
+TEST_CASE("Compression ratio against reconstruction error for the image", "[CSpectrumCodec]") {
+    std::vector<CComplex> image = Helper::readValues("data/image_original.txt");
+    std::vector<CComplex> spectrum = CComplex::fft2d(image, 64, 64);
+    auto inverse = [](const std::vector<CComplex>& values) { return CComplex::fft2d(values, 64, 64, true); };
+
+    std::cout << "Image compression:" << std::endl;
+
+    for (double epsilon : {-1.0, 10.0, 100.0}) {
+        double thresholdDeviation = Helper::maxDeviation(image, inverse(CSpectrumCodec(epsilon, 1e-12).decode(CSpectrumCodec(epsilon, 1e-12).encode(spectrum))));
+        double previousRatio = 0;
+
+        for (double step : {1e-6, 0.01, 1.0}) {
+            CSpectrumCodec::Report report = CSpectrumCodec(epsilon, step).report(image, spectrum, inverse);
+
+            std::cout << "epsilon " << epsilon << ", step " << step << ": " << report.nonZeros << " coefficients, "
+                      << report.textBytes << " -> " << report.compressedBytes << " bytes (ratio " << report.ratio
+                      << "), deviation " << report.maxDeviation << std::endl;
+
+            // every component is off by at most step / 2, the unitary inverse spreads that over all pixels
+            REQUIRE(report.maxDeviation <= thresholdDeviation + report.nonZeros * step / std::sqrt(2.0 * 4096) + 1e-9);
+            REQUIRE(report.ratio > previousRatio);
+            REQUIRE(report.ratio > 2);
+            previousRatio = report.ratio;
+        }
+    }
+}
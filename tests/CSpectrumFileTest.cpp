@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "../lib/CComplex.h"
+#include "../lib/CSpectrumFile.h"
+#include "../lib/Helper.h"
+
+using namespace Catch::Matchers;
+
+namespace {
+    // written spectrum files go to the temporary directory, not into data/
+    std::string scratchFile(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+}
+
+TEST_CASE("Dense and sparse spectrum files round trip", "[CSpectrumFile]") {
+    std::vector<CComplex> values = Helper::readValues("data/example1.txt");
+    std::vector<CComplex> spectrum = CComplex::fft(values);
+
+    SECTION("Dense") {
+        CSpectrumFile::write(scratchFile("example1_dft.spec"), spectrum);
+        CSpectrumFile file(scratchFile("example1_dft.spec"));
+
+        REQUIRE(file.kind() == CSpectrumFile::Kind::Dense);
+        REQUIRE(file.size() == 1000);
+        REQUIRE(file.threshold() == -1);
+        REQUIRE(file.dense().size() == 1000);
+        REQUIRE(Helper::maxDeviation(file.toVector(), spectrum) == 0);
+        REQUIRE_THROWS_AS(file.entries(), std::invalid_argument);
+        std::filesystem::remove(scratchFile("example1_dft.spec"));
+    }
+
+    SECTION("Sparse") {
+        CSpectrumFile::write(scratchFile("example1_dft_1.spec"), spectrum, 1);
+        CSpectrumFile file(scratchFile("example1_dft_1.spec"));
+        CSparseSpectrum sparse(spectrum, 1);
+
+        REQUIRE(file.kind() == CSpectrumFile::Kind::Sparse);
+        REQUIRE(file.size() == 1000);
+        REQUIRE(file.count() == sparse.nonZeros());
+        REQUIRE(file.threshold() == 1);
+
+        for (int i = 0; i < file.count(); i++) {
+            REQUIRE(file.entries()[i].index == sparse.index(i));
+            REQUIRE(file.entries()[i].value == sparse.value(i));
+        }
+
+        REQUIRE(Helper::maxDeviation(file.toVector(), sparse.toDense()) == 0);
+        REQUIRE(Helper::maxDeviation(file.toSparse().idft(), sparse.idft()) == 0);
+        std::filesystem::remove(scratchFile("example1_dft_1.spec"));
+    }
+}
+
+TEST_CASE("Text spectra convert to the binary format", "[CSpectrumFile]") {
+    CSpectrumFile::convertText("data/example1_dft_1.txt", scratchFile("example1_dft_1.spec"), 1);
+    CSpectrumFile sparse(scratchFile("example1_dft_1.spec"));
+
+    REQUIRE(sparse.kind() == CSpectrumFile::Kind::Sparse);
+    REQUIRE(sparse.count() == 57);
+    REQUIRE(Helper::maxDeviation(sparse.toVector(), Helper::readValues("data/example1_dft_1.txt")) == 0);
+
+    CSpectrumFile::convertText("data/example1.txt", scratchFile("example1.spec"));
+    CSpectrumFile dense(scratchFile("example1.spec"));
+
+    REQUIRE(dense.kind() == CSpectrumFile::Kind::Dense);
+    REQUIRE(Helper::maxDeviation(dense.toVector(), Helper::readValues("data/example1.txt")) == 0);
+
+    std::filesystem::remove(scratchFile("example1_dft_1.spec"));
+    std::filesystem::remove(scratchFile("example1.spec"));
+}
+
+TEST_CASE("Damaged spectrum files are rejected", "[CSpectrumFile]") {
+    std::vector<CComplex> values = {CComplex(1, 2), CComplex(3, 4), CComplex(5, 6)};
+    CSpectrumFile::writeDense(scratchFile("damaged.spec"), values);
+
+    std::fstream fp(scratchFile("damaged.spec"), std::ios::in | std::ios::out | std::ios::binary);
+    fp.seekp(48 + 8);
+    fp.put(1);
+    fp.close();
+
+    REQUIRE_THROWS_AS(CSpectrumFile(scratchFile("damaged.spec")), std::runtime_error);
+    REQUIRE(CSpectrumFile(scratchFile("damaged.spec"), false).dense()[1] == CComplex(3, 4));
+
+    // count * 16 wraps around to the real payload length
+    CSpectrumFile::writeDense(scratchFile("damaged.spec"), values);
+    std::int64_t count = 3 + (std::int64_t(1) << 60);
+    fp.open(scratchFile("damaged.spec"), std::ios::in | std::ios::out | std::ios::binary);
+    fp.seekp(8);
+    fp.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    fp.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    fp.close();
+
+    REQUIRE_THROWS_AS(CSpectrumFile(scratchFile("damaged.spec")), std::runtime_error);
+
+    REQUIRE_THROWS_AS(CSpectrumFile("data/example1.txt"), std::runtime_error);
+    REQUIRE_THROWS_AS(CSpectrumFile("data/missing.spec"), std::runtime_error);
+
+    std::filesystem::remove(scratchFile("damaged.spec"));
+}
@@ -0,0 +1,62 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "../lib/CComplex.h"
+#include "../lib/CThreadPool.h"
+#include "../lib/Helper.h"
+
+TEST_CASE("CThreadPool covers every index exactly once", "[CThreadPool]") {
+    CThreadPool::setThreadCount(4);
+    CThreadPool& pool = CThreadPool::instance();
+    REQUIRE(pool.threadCount() == 4);
+
+    std::vector<int> hits(10007, 0);
+    pool.parallelFor(0, hits.size(), 10, [&](int from, int to) {
+        for (int i = from; i < to; i++) hits[i]++;
+    });
+
+    for (int hit : hits) {
+        REQUIRE(hit == 1);
+    }
+
+    SECTION("Nested loops run without deadlock") {
+        std::atomic<int> sum(0);
+        pool.parallelFor(0, 8, 1, [&](int from, int to) {
+            for (int i = from; i < to; i++) {
+                pool.parallelFor(0, 100, 1, [&](int innerFrom, int innerTo) {
+                    sum += innerTo - innerFrom;
+                });
+            }
+        });
+        REQUIRE(sum == 800);
+    }
+
+    SECTION("Exceptions are passed to the caller") {
+        REQUIRE_THROWS_AS(pool.parallelFor(0, 100, 1, [](int from, int to) {
+            if (from <= 50 && 50 < to) throw std::invalid_argument("chunk failed");
+        }), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Parallel transforms are bit-identical to serial ones", "[CThreadPool]") {
+    std::vector<CComplex> values(1 << 15);
+    for (int i = 0; i < values.size(); i++) {
+        values[i] = CComplex(std::sin(i * 0.01), std::cos(i * 0.37));
+    }
+    std::vector<CComplex> mixed(values.begin(), values.begin() + 3 * (1 << 13));
+    std::vector<CComplex> small(values.begin(), values.begin() + 1000);
+
+    CThreadPool::setThreadCount(1);
+    std::vector<CComplex> fftSerial = CComplex::fft(values);
+    std::vector<CComplex> mixedSerial = CComplex::fft(mixed);
+    std::vector<CComplex> dftSerial = CComplex::dft(small);
+    std::vector<CComplex> fft2dSerial = CComplex::fft2d(values, 128, 256);
+
+    CThreadPool::setThreadCount(4);
+    REQUIRE(Helper::maxDeviation(fftSerial, CComplex::fft(values)) == 0);
+    REQUIRE(Helper::maxDeviation(mixedSerial, CComplex::fft(mixed)) == 0);
+    REQUIRE(Helper::maxDeviation(dftSerial, CComplex::dft(small)) == 0);
+    REQUIRE(Helper::maxDeviation(fft2dSerial, CComplex::fft2d(values, 128, 256)) == 0);
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <stdexcept>
+#include "../lib/CDGLSolver.h"
+#include "../lib/CFixedVector.h"
+#include "../lib/CTrajectory.h"
+
+using namespace Catch::Matchers;
+
+namespace {
+    // y = 1/x with y(1) = 1, y'(1) = -1, y''(1) = 2
+    template<typename V>
+    double nthOrder(const V& y, double x) {
+        return 2 * x * y.get(1) * y.get(2) + 2 * y.get(0) * y.get(0) * y.get(1);
+    }
+
+    template<typename V>
+    double maximumError(const CTrajectory<V>& trajectory) {
+        double error = 0;
+        for (int i = 0; i <= 1000; i++) {
+            double x = trajectory.xStart() + (trajectory.xEnd() - trajectory.xStart()) * i / 1000;
+            V y = trajectory(x);
+            error = std::max(error, std::abs(y.get(0) - 1 / x));
+            error = std::max(error, std::abs(y.get(1) + 1 / (x * x)));
+        }
+
+        return error;
+    }
+}
+
+TEST_CASE("Trajectories answer queries between the steps", "[CTrajectory]") {
+    int evaluations = 0;
+    auto f = [&evaluations](const CMyVector& y, double x) {
+        evaluations++;
+        return nthOrder(y, x);
+    };
+
+    CMyVector yStart({1.0, -1.0, 2.0});
+
+    SECTION("Dormand-Prince") {
+        CTrajectory<CMyVector> trajectory = CDGLSolver<>::trajectory(f, 1.0, 3.0, yStart, 1e-10);
+        REQUIRE(trajectory.steps() < 100);
+        REQUIRE(evaluations < 600);
+        REQUIRE(maximumError(trajectory) < 1e-8);
+
+        // recording a trajectory does not change the steps
+        REQUIRE(trajectory(3.0) == CDGLSolver<>::dormandPrince(f, 1.0, 3.0, yStart, 1e-10));
+    }
+
+    SECTION("Runge-Kutta with Hermite interpolation") {
+        CTrajectory<CMyVector> trajectory = CDGLSolver<>::trajectory(f, 1.0, 3.0, 200, yStart);
+        REQUIRE(trajectory.steps() == 200);
+        REQUIRE(evaluations == 801);
+        REQUIRE(maximumError(trajectory) < 1e-7);
+
+        REQUIRE(trajectory(3.0) == CDGLSolver<>::rungeKutta(f, 1.0, 3.0, 200, yStart));
+    }
+
+    SECTION("Backwards") {
+        CDGLSolver solver(nthOrder<CMyVector>);
+        CTrajectory<CMyVector> trajectory = solver.trajectory(3.0, 1.0, CMyVector({1.0 / 3, -1.0 / 9, 2.0 / 27}));
+        REQUIRE(maximumError(trajectory) < 1e-7);
+    }
+
+    SECTION("Fixed vectors") {
+        CTrajectory<CFixedVector<3>> trajectory = CDGLSolver<CFixedVector<3>>::trajectory(nthOrder<CFixedVector<3>>, 1.0, 3.0, {1.0, -1.0, 2.0});
+        REQUIRE(maximumError(trajectory) < 1e-7);
+    }
+}
+
+TEST_CASE("Trajectories only answer queries in their range", "[CTrajectory]") {
+    CTrajectory<CMyVector> empty(1.0, CMyVector({2.0}));
+    REQUIRE(empty(1.0) == CMyVector({2.0}));
+    REQUIRE_THROWS_AS(empty(1.5), std::out_of_range);
+
+    CTrajectory<CMyVector> trajectory = CDGLSolver<>::trajectory(nthOrder<CMyVector>, 1.0, 2.0, 10, CMyVector({1.0, -1.0, 2.0}));
+    REQUIRE(trajectory.nodes().size() == 11);
+    REQUIRE(trajectory.xEnd() == 2.0);
+    REQUIRE_THROWS_AS(trajectory(0.5), std::out_of_range);
+    REQUIRE_THROWS_AS(trajectory(2.5), std::out_of_range);
+    REQUIRE(trajectory(1.0) == CMyVector({1.0, -1.0, 2.0}));
+}
@@ -1,13 +1,49 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include "../lib/CComplex.h"
+#include "../lib/CComplexBuffer.h"
+#include "../lib/CFFTPlan.h"
+#include "../lib/CSparseSpectrum.h"
 #include "../lib/Helper.h"
 
 using namespace Catch::Matchers;
 
+namespace {
+    // the recursive radix-2 FFT that CComplex::fft used before the in-place engine, unnormalized
+    std::vector<CComplex> fftRecursive(const std::vector<CComplex>& values, bool inverse) {
+        int N = values.size();
+        if (N == 1) return values;
+
+        std::vector<CComplex> even(N / 2), odd(N / 2);
+        for (int i = 0; i < N / 2; i++) {
+            even[i] = values[2 * i];
+            odd[i] = values[2 * i + 1];
+        }
+
+        even = fftRecursive(even, inverse);
+        odd = fftRecursive(odd, inverse);
+
+        double factor = (inverse ? 2.0 : -2.0) * M_PI / N;
+
+        std::vector<CComplex> result(N);
+        for (int k = 0; k < N / 2; k++) {
+            CComplex t = CComplex(factor * k) * odd[k];
+
+            result[k] = even[k] + t;
+            result[k + N / 2] = even[k] - t;
+        }
+
+        return result;
+    }
+}
+
 TEST_CASE("Helper function can read valid file", "[Helper]") {
     std::vector<CComplex> values1 = Helper::readValues("data/example1.txt");
 
@@ -25,6 +61,59 @@ TEST_CASE("Helper function can read valid file", "[Helper]") {
     REQUIRE(values2[999] == CComplex(14.9507097, 2.998519681));
 }
 
+TEST_CASE("Helper writes and reads the text format like iostreams", "[Helper]") {
+    std::vector<CComplex> values = {
+        CComplex(11.9, 0), CComplex(-0.0, 1e-300), CComplex(1e20, -123456789.123456789),
+        CComplex(0.1, 2.0 / 3), CComplex(1e-5, -1e15), CComplex(9999999999.5, 0.00012345678915),
+        CComplex(1e-300, -2.5e300), CComplex(-462.5952567, -0.1394705562)
+    };
+
+    std::ostringstream expected;
+    expected << values.size() << "\n";
+    expected.precision(10);
+    for (int i = 0; i < values.size(); i++) {
+        expected << i << "\t" << values[i].re() << "\t" << values[i].im() << "\n";
+    }
+
+    // scratch files go to the temporary directory, not into data/
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string roundtrip = (directory / "helper_roundtrip.txt").string();
+    std::string gapsFile = (directory / "helper_gaps.txt").string();
+    std::string broken = (directory / "helper_broken.txt").string();
+
+    Helper::writeValues(roundtrip, values);
+    REQUIRE(Helper::readFile(roundtrip) == expected.str());
+
+    std::istringstream in(expected.str());
+    std::vector<CComplex> parsed(values.size());
+    int N, idx;
+    double re, im;
+    in >> N;
+    while (in >> idx >> re >> im) {
+        parsed[idx] = CComplex(re, im);
+    }
+
+    std::vector<CComplex> read = Helper::readValues(roundtrip);
+    REQUIRE(read.size() == N);
+    for (int i = 0; i < N; i++) {
+        REQUIRE(read[i] == parsed[i]);
+    }
+
+    std::ofstream(gapsFile) << "4\n1 2.5 -1\n3 0.25 0";
+    std::vector<CComplex> gaps = Helper::readValues(gapsFile);
+    REQUIRE(gaps == std::vector<CComplex>{CComplex(0, 0), CComplex(2.5, -1), CComplex(0, 0), CComplex(0.25, 0)});
+
+    std::ofstream(broken) << "4\n1 2.5 x\n";
+    REQUIRE_THROWS_AS(Helper::readValues(broken), std::invalid_argument);
+    std::ofstream(broken) << "4\n4 2.5 1\n";
+    REQUIRE_THROWS_AS(Helper::readValues(broken), std::out_of_range);
+    REQUIRE_THROWS_AS(Helper::readValues("data/missing.txt"), std::runtime_error);
+
+    std::filesystem::remove(roundtrip);
+    std::filesystem::remove(gapsFile);
+    std::filesystem::remove(broken);
+}
+
 TEST_CASE("Simple DFT-IDFT Test", "[CComplex]") {
     std::vector<CComplex> values = {
         CComplex(1, 0),
@@ -128,33 +217,321 @@ TEST_CASE("DFT deviations for example2 are correct", "[CComplex]") {
 
 TEST_CASE("DFT images", "[CComplex]") {
     std::vector<CComplex> values = Helper::readValues("data/image_original.txt");
+    int size = std::sqrt(values.size());
+    std::vector<CComplex> dftValues = CComplex::fft2d(values, size, size);
+
+    REQUIRE(Helper::maxDeviation(values, CComplex::fft2d(dftValues, size, size, true)) < 1e-9);
+
+    // the spectra and reconstructions go to the temporary directory, the
+    // files in data/ are the 1D results that image2array.py was run on
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    double previous = 0;
+
+    for (int epsilon : {-1, 10, 30, 100, 300, 1000}) {
+        std::string suffix = epsilon < 0 ? "" : std::string("_") + std::to_string(epsilon);
+        std::string dftFile = (directory / ("image_dft" + suffix + ".txt")).string();
+        std::string idftFile = (directory / ("image_idft" + suffix + ".txt")).string();
+
+        Helper::writeValues(dftFile, dftValues, epsilon);
+        std::vector<CComplex> idftValues = CComplex::fft2d(Helper::readValues(dftFile), size, size, true);
+        Helper::writeValues(idftFile, idftValues);
+
+        // dropping more coefficients moves the image further from the original
+        double deviation = Helper::maxDeviation(values, idftValues);
+        std::cout << "Image deviation " << epsilon << ": " << deviation << std::endl;
+        REQUIRE(deviation >= previous);
+        previous = deviation;
+
+        std::filesystem::remove(dftFile);
+        std::filesystem::remove(idftFile);
+    }
+
+    REQUIRE(previous > 1);
+}
+
+TEST_CASE("FFT matches DFT for power of two sizes", "[CComplex]") {
+    std::vector<CComplex> values = Helper::readValues("data/image_original.txt");
+
     std::vector<CComplex> dftValues = CComplex::dft(values);
+    std::vector<CComplex> fftValues = CComplex::fft(values);
 
-    Helper::writeValues("data/image_dft.txt", dftValues);
-    Helper::writeValues("data/image_dft_10.txt", dftValues, 10);
-    Helper::writeValues("data/image_dft_30.txt", dftValues, 30);
-    Helper::writeValues("data/image_dft_100.txt", dftValues, 100);
-    Helper::writeValues("data/image_dft_300.txt", dftValues, 300);
-    Helper::writeValues("data/image_dft_1000.txt", dftValues, 1000);
+    REQUIRE(Helper::maxDeviation(dftValues, fftValues) < 1e-8);
 
-    std::vector<CComplex> dft_default = Helper::readValues("data/image_dft.txt");
-    std::vector<CComplex> dft_10 = Helper::readValues("data/image_dft_10.txt");
-    std::vector<CComplex> dft_30 = Helper::readValues("data/image_dft_30.txt");
-    std::vector<CComplex> dft_100 = Helper::readValues("data/image_dft_100.txt");
-    std::vector<CComplex> dft_300 = Helper::readValues("data/image_dft_300.txt");
-    std::vector<CComplex> dft_1000 = Helper::readValues("data/image_dft_1000.txt");
+    std::vector<CComplex> inPlace(values);
+    CComplex::fftInPlace(inPlace);
+    REQUIRE(Helper::maxDeviation(fftValues, inPlace) == 0);
 
-    std::vector<CComplex> idft_default = CComplex::idft(dft_default);
-    std::vector<CComplex> idft_10 = CComplex::idft(dft_10);
-    std::vector<CComplex> idft_30 = CComplex::idft(dft_30);
-    std::vector<CComplex> idft_100 = CComplex::idft(dft_100);
-    std::vector<CComplex> idft_300 = CComplex::idft(dft_300);
-    std::vector<CComplex> idft_1000 = CComplex::idft(dft_1000);
-
-    Helper::writeValues("data/image_idft.txt", idft_default);
-    Helper::writeValues("data/image_idft_10.txt", idft_10);
-    Helper::writeValues("data/image_idft_30.txt", idft_30);
-    Helper::writeValues("data/image_idft_100.txt", idft_100);
-    Helper::writeValues("data/image_idft_300.txt", idft_300);
-    Helper::writeValues("data/image_idft_1000.txt", idft_1000);
+    CComplex::fftInPlace(inPlace, true);
+    REQUIRE(Helper::maxDeviation(values, inPlace) < 1e-10);
+}
+
+TEST_CASE("FFT matches the former recursive FFT", "[CComplex]") {
+    std::vector<CComplex> image = Helper::readValues("data/image_original.txt");
+    std::vector<CComplex> example = Helper::readValues("data/example1.txt");
+    example.resize(512);
+
+    for (const std::vector<CComplex>& values : {image, example}) {
+        for (bool inverse : {false, true}) {
+            std::vector<CComplex> expected = fftRecursive(values, inverse);
+            double scale = 1.0 / std::sqrt(values.size());
+            for (auto& c : expected) {
+                c *= scale;
+            }
+
+            REQUIRE(Helper::maxDeviation(expected, CComplex::fft(values, inverse)) < 1e-12);
+        }
+    }
+}
+
+TEST_CASE("FFT matches DFT for arbitrary sizes", "[CComplex]") {
+    std::vector<CComplex> example1 = Helper::readValues("data/example1.txt");
+    std::vector<CComplex> example2 = Helper::readValues("data/example2.txt");
+
+    REQUIRE(Helper::maxDeviation(CComplex::dft(example1), CComplex::fft(example1)) < 1e-10);
+    REQUIRE(Helper::maxDeviation(CComplex::idft(example2), CComplex::fft(example2, true)) < 1e-10);
+
+    for (int N : {3, 5, 6, 7, 12, 30, 97, 100, 210}) {
+        std::vector<CComplex> values(N);
+        for (int i = 0; i < N; i++) {
+            values[i] = CComplex(std::sin(i * 0.7), std::cos(i * i * 0.3));
+        }
+
+        REQUIRE(Helper::maxDeviation(CComplex::dft(values), CComplex::fft(values)) < 1e-12);
+        REQUIRE(Helper::maxDeviation(values, CComplex::fft(CComplex::fft(values), true)) < 1e-12);
+    }
+}
+
+TEST_CASE("FFT plans are cached per size and direction", "[CFFTPlan]") {
+    const CFFTPlan& forward = CFFTPlan::get(8);
+    const CFFTPlan& inverse = CFFTPlan::get(8, true);
+
+    REQUIRE(&forward == &CFFTPlan::get(8));
+    REQUIRE(&forward != &inverse);
+    REQUIRE(forward.size() == 8);
+    REQUIRE(inverse.inverse());
+
+    REQUIRE_THAT(forward.twiddle(2).re(), WithinAbs(0, 1e-15));
+    REQUIRE_THAT(forward.twiddle(2).im(), WithinAbs(-1, 1e-15));
+    REQUIRE_THAT(inverse.twiddle(2).im(), WithinAbs(1, 1e-15));
+}
+
+TEST_CASE("CComplexBuffer stores split aligned arrays", "[CComplexBuffer]") {
+    std::vector<CComplex> values = Helper::readValues("data/image_original.txt");
+    CComplexBuffer buffer(values);
+
+    REQUIRE(buffer.size() == 4096);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(buffer.re()) % 64 == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(buffer.im()) % 64 == 0);
+    REQUIRE(buffer.get(17) == values[17]);
+    REQUIRE(Helper::maxDeviation(values, buffer.toVector()) == 0);
+
+    SECTION("FFT on split arrays matches the FFT on CComplex values") {
+        buffer.fft();
+        REQUIRE(Helper::maxDeviation(CComplex::fft(values), buffer.toVector()) < 1e-12);
+
+        buffer.fft(true);
+        REQUIRE(Helper::maxDeviation(values, buffer.toVector()) < 1e-12);
+    }
+
+    SECTION("Other sizes fall back to the plan on CComplex values") {
+        std::vector<CComplex> example = Helper::readValues("data/example2.txt");
+        CComplexBuffer exampleBuffer(example);
+
+        exampleBuffer.fft();
+        REQUIRE(Helper::maxDeviation(CComplex::fft(example), exampleBuffer.toVector()) < 1e-12);
+    }
+}
+
+TEST_CASE("Real FFT returns the non-redundant half of the spectrum", "[CComplex]") {
+    for (const char* file : {"data/example1.txt", "data/image_original.txt"}) {
+        std::vector<CComplex> values = Helper::readValues(file);
+        std::vector<double> real = Helper::readRealValues(file);
+        int N = real.size();
+
+        std::vector<CComplex> full = CComplex::fft(values);
+        std::vector<CComplex> half = CComplex::rfft(real);
+
+        REQUIRE(half.size() == N / 2 + 1);
+        REQUIRE(Helper::maxDeviation(std::vector<CComplex>(full.begin(), full.begin() + N / 2 + 1), half) < 1e-10);
+
+        std::vector<double> restored = CComplex::irfft(half, N);
+        for (int n = 0; n < N; n++) {
+            REQUIRE_THAT(restored[n], WithinAbs(real[n], 1e-10));
+        }
+    }
+
+    std::vector<double> odd = {1, -2, 0.5, 4, 3};
+    std::vector<double> restored = CComplex::irfft(CComplex::rfft(odd), odd.size());
+    for (int n = 0; n < odd.size(); n++) {
+        REQUIRE_THAT(restored[n], WithinAbs(odd[n], 1e-12));
+    }
+}
+
+TEST_CASE("Thresholded real spectrum reconstructs like the full spectrum", "[Helper]") {
+    std::vector<CComplex> values = Helper::readValues("data/example1.txt");
+    std::vector<double> real = Helper::readRealValues("data/example1.txt");
+
+    // the scratch file goes to the temporary directory, not into data/
+    std::string filename = (std::filesystem::temp_directory_path() / "example1_rfft_01.txt").string();
+
+    std::vector<CComplex> half = CComplex::rfft(real);
+    Helper::writeRealSpectrum(filename, half, real.size(), 0.1);
+
+    std::vector<CComplex> stored = Helper::readValues(filename);
+    std::filesystem::remove(filename);
+    std::vector<double> restored = CComplex::irfft(stored, stored.size());
+
+    std::vector<CComplex> full = CComplex::fft(values);
+    for (auto& c : full) {
+        if (c.abs() <= 0.1) c = CComplex(0, 0);
+    }
+    std::vector<CComplex> expected = CComplex::fft(full, true);
+
+    for (int n = 0; n < real.size(); n++) {
+        REQUIRE_THAT(restored[n], WithinAbs(expected[n].re(), 1e-8));
+    }
+}
+
+TEST_CASE("2D FFT matches the 2D DFT definition", "[CComplex]") {
+    int rows = 4, cols = 6;
+    std::vector<CComplex> values(rows * cols);
+    for (int i = 0; i < values.size(); i++) {
+        values[i] = CComplex(std::sin(i * 1.3), std::cos(i * 0.4));
+    }
+
+    std::vector<CComplex> expected(rows * cols);
+    for (int k = 0; k < rows; k++) {
+        for (int l = 0; l < cols; l++) {
+            CComplex sum;
+            for (int r = 0; r < rows; r++) {
+                for (int c = 0; c < cols; c++) {
+                    sum += values[r * cols + c] * CComplex(-2 * M_PI * (double(k * r) / rows + double(l * c) / cols));
+                }
+            }
+            expected[k * cols + l] = sum / std::sqrt(rows * cols);
+        }
+    }
+
+    std::vector<CComplex> spectrum = CComplex::fft2d(values, rows, cols);
+    REQUIRE(Helper::maxDeviation(expected, spectrum) < 1e-12);
+    REQUIRE(Helper::maxDeviation(values, CComplex::fft2d(spectrum, rows, cols, true)) < 1e-12);
+
+    std::vector<CComplex> image = Helper::readValues("data/image_original.txt");
+    REQUIRE(Helper::maxDeviation(image, CComplex::fft2d(CComplex::fft2d(image, 64, 64), 64, 64, true)) < 1e-10);
+
+    REQUIRE_THROWS_AS(CComplex::fft2d(values, 5, 5), std::invalid_argument);
+}
+
+TEST_CASE("Batched transforms match single transforms", "[CComplex]") {
+    std::vector<CComplex> example1 = Helper::readValues("data/example1.txt");
+    std::vector<CComplex> example2 = Helper::readValues("data/example2.txt");
+
+    SECTION("Contiguous signals of arbitrary length") {
+        std::vector<CComplex> batch(example1);
+        batch.insert(batch.end(), example2.begin(), example2.end());
+
+        CComplex::fftBatch(batch, 1000, 2, 1, 1000);
+
+        std::vector<CComplex> expected = CComplex::fft(example1);
+        std::vector<CComplex> expected2 = CComplex::fft(example2);
+        expected.insert(expected.end(), expected2.begin(), expected2.end());
+        REQUIRE(Helper::maxDeviation(expected, batch) < 1e-12);
+    }
+
+    SECTION("Interleaved power of two signals") {
+        int n = 256, howmany = 11;
+        std::vector<CComplex> batch(n * howmany);
+        for (int b = 0; b < howmany; b++) {
+            for (int j = 0; j < n; j++) {
+                batch[j * howmany + b] = example2[b * 37 + j];
+            }
+        }
+
+        std::vector<CComplex> direct(batch);
+        CComplex::fftBatch(batch, n, howmany, howmany, 1, true);
+        CComplex::dftBatch(direct, n, howmany, howmany, 1, true);
+
+        for (int b = 0; b < howmany; b++) {
+            std::vector<CComplex> signal(example2.begin() + b * 37, example2.begin() + b * 37 + n);
+            std::vector<CComplex> expected = CComplex::idft(signal);
+
+            for (int j = 0; j < n; j++) {
+                REQUIRE((batch[j * howmany + b] - expected[j]).abs() < 1e-12);
+                REQUIRE((direct[j * howmany + b] - expected[j]).abs() < 1e-12);
+            }
+        }
+    }
+
+    SECTION("Layouts outside the buffer are rejected") {
+        std::vector<CComplex> batch(100);
+        REQUIRE_THROWS_AS(CComplex::fftBatch(batch, 10, 11, 1, 10), std::invalid_argument);
+    }
+
+    SECTION("Overlapping signals are rejected") {
+        std::vector<CComplex> batch(100);
+        REQUIRE_THROWS_AS(CComplex::fftBatch(batch, 10, 2, 1, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(CComplex::fftBatch(batch, 10, 5, 1, 5), std::invalid_argument);
+        REQUIRE_THROWS_AS(CComplex::dftBatch(batch, 10, 3, 2, 4), std::invalid_argument);
+
+        // interleaved and gapped signals are disjoint
+        REQUIRE_NOTHROW(CComplex::fftBatch(batch, 10, 10, 10, 1));
+        REQUIRE_NOTHROW(CComplex::fftBatch(batch, 5, 10, 2, 9));
+        REQUIRE_NOTHROW(CComplex::dftBatch(batch, 1, 100, 1, 1));
+    }
+}
+
+TEST_CASE("Sparse spectra skip their zero coefficients", "[CSparseSpectrum]") {
+    std::vector<CComplex> values = Helper::readValues("data/example1.txt");
+    std::vector<CComplex> dense = Helper::readValues("data/example1_dft_1.txt");
+    CSparseSpectrum sparse = Helper::readSparseValues("data/example1_dft_1.txt");
+
+    REQUIRE(sparse.size() == 1000);
+    REQUIRE(sparse.nonZeros() == 57);
+    REQUIRE(sparse.density() < 0.06);
+    REQUIRE(Helper::maxDeviation(sparse.toDense(), dense) == 0);
+
+    // same summation order as the dense definition
+    std::vector<CComplex> reference(1000);
+    for (int n = 0; n < 1000; n++) {
+        CComplex sum;
+        for (int k = 0; k < 1000; k++) {
+            sum += dense[k] * CFFTPlan::get(1000, true).twiddle((long long)k * n % 1000);
+        }
+        reference[n] = sum / sqrt(1000);
+    }
+
+    std::vector<CComplex> idft = sparse.idft();
+    REQUIRE(Helper::maxDeviation(idft, reference) == 0);
+    REQUIRE(Helper::maxDeviation(CComplex::idft(dense), reference) == 0);
+    REQUIRE(Helper::maxDeviation(sparse.inverse(), reference) < 1e-10);
+
+    CSparseSpectrum few(4096);
+    few.add(3, CComplex(1, 2));
+    few.add(100, CComplex(-0.5, 0));
+    REQUIRE(few.prefersDirect());
+    REQUIRE(Helper::maxDeviation(CComplex::fft(few.toDense(), true), CComplex::idft(few.toDense())) < 1e-12);
+    REQUIRE_FALSE(CSparseSpectrum(values).prefersDirect());
+
+    REQUIRE_THROWS_AS(few.add(50, CComplex(1, 0)), std::invalid_argument);
+    REQUIRE_THROWS_AS(few.add(4096, CComplex(1, 0)), std::out_of_range);
+}
+
+TEST_CASE("2D inverse FFT of a thresholded spectrum", "[CComplex]") {
+    std::vector<CComplex> image = Helper::readValues("data/image_original.txt");
+    CSparseSpectrum spectrum(CComplex::fft2d(image, 64, 64), 100);
+    std::vector<CComplex> thresholded = spectrum.toDense();
+
+    std::vector<CComplex> expected = thresholded;
+    for (int r = 0; r < 64; r++) {
+        CComplex::fftInPlace(std::span<CComplex>(expected.data() + r * 64, 64), true);
+    }
+    for (int c = 0; c < 64; c++) {
+        std::vector<CComplex> column(64);
+        for (int r = 0; r < 64; r++) column[r] = expected[r * 64 + c];
+        column = CComplex::fft(column, true);
+        for (int r = 0; r < 64; r++) expected[r * 64 + c] = column[r];
+    }
+
+    REQUIRE(spectrum.nonZeros() < 100);
+    REQUIRE(Helper::maxDeviation(CComplex::fft2d(thresholded, 64, 64, true), expected) < 1e-10);
 }
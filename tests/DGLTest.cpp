@@ -62,6 +62,73 @@ TEST_CASE("CDGLSolver can solve nth order equations", "[CDGLSolver]") {
     }
 }
 
+TEST_CASE("Runge-Kutta methods need fewer evaluations", "[CDGLSolver]") {
+    // y = 1/x solves the nth order equation with these start values
+    int evaluations = 0;
+    auto f = [&evaluations](const CMyVector& y, double x) {
+        evaluations++;
+        return dgl_nth_order(y, x);
+    };
+
+    CMyVector yStart({1.0, -1.0, 2.0});
+
+    SECTION("Heun") {
+        CMyVector y = CDGLSolver<>::heun(f, 1.0, 2.0, 10000, yStart);
+        REQUIRE(evaluations == 20000);
+        REQUIRE_THAT(y.get(0), WithinAbs(0.5, 1e-7));
+    }
+
+    SECTION("Runge-Kutta") {
+        CMyVector y = CDGLSolver<>::rungeKutta(f, 1.0, 2.0, 100, yStart);
+        REQUIRE(evaluations == 400);
+        REQUIRE_THAT(y.get(0), WithinAbs(0.5, 1e-8));
+    }
+
+    SECTION("Dormand-Prince") {
+        CMyVector y = CDGLSolver<>::dormandPrince(f, 1.0, 2.0, yStart, 1e-10);
+        REQUIRE(evaluations < 400);
+        REQUIRE_THAT(y.get(0), WithinAbs(0.5, 1e-9));
+        REQUIRE_THAT(y.get(1), WithinAbs(-0.25, 1e-9));
+        REQUIRE_THAT(y.get(2), WithinAbs(0.25, 1e-9));
+    }
+
+    SECTION("Bogacki-Shampine") {
+        CMyVector y = CDGLSolver<>::bogackiShampine(f, 1.0, 2.0, yStart, 1e-7);
+        REQUIRE(evaluations < 2000);
+        REQUIRE_THAT(y.get(0), WithinAbs(0.5, 1e-6));
+    }
+
+    SECTION("Backwards") {
+        CDGLSolver solver(dgl_nth_order);
+        CMyVector y = solver.dormandPrince(2.0, 1.0, CMyVector({0.5, -0.25, 0.25}));
+        REQUIRE_THAT(y.get(0), WithinAbs(1, 1e-7));
+        REQUIRE_THAT(y.get(1), WithinAbs(-1, 1e-7));
+    }
+
+    if (evaluations > 0) {
+        std::cout << "Auswertungen von f: " << evaluations << std::endl;
+    }
+}
+
+TEST_CASE("Adaptive methods fail on singular right hand sides", "[CDGLSolver]") {
+    std::streambuf* output = std::cout.rdbuf();
+
+    SECTION("Blow-up") {
+        // y = 1 / (1 - x) has a pole at x = 1
+        auto f = [](const CMyVector& y, double x) { return CMyVector({y.get(0) * y.get(0)}); };
+        REQUIRE_THROWS_AS(CDGLSolver<>::dormandPrince(f, 0.0, 2.0, CMyVector({1.0})), std::runtime_error);
+    }
+
+    SECTION("Not a number") {
+        auto f = [](const CMyVector& y, double x) { return CMyVector({x < 0.5 ? y.get(0) : std::nan("")}); };
+        REQUIRE_THROWS_AS(CDGLSolver<>::dormandPrince(f, 0.0, 1.0, CMyVector({1.0})), std::runtime_error);
+        REQUIRE_THROWS_AS(CDGLSolver<>::bogackiShampine(f, 0.0, 1.0, CMyVector({1.0})), std::runtime_error);
+    }
+
+    // the output muted during the integration is restored
+    REQUIRE(std::cout.rdbuf() == output);
+}
+
 TEST_CASE("DGLSolver can be used to minimize", "[CDGLSolver]") {
     std::vector<double> target = {0.015, 0.027, 0.059, 0.112, 0.209, 0.350, 0.523};
 
@@ -79,10 +146,12 @@ TEST_CASE("DGLSolver can be used to minimize", "[CDGLSolver]") {
             return equation(y, x, lambda);
         });
         
+        // one integration answers all sample points
+        CTrajectory<CMyVector> trajectory = solver.trajectory(0.0, target.size() - 1, y_start);
         CMyVector result(target.size());
 
         for(int i = 0; i < target.size(); ++i) {
-            result[i] = solver.heun(0.0, i, 10000, y_start).get(0);
+            result[i] = trajectory(i).get(0);
         }
 
         return result;
@@ -107,5 +176,7 @@ TEST_CASE("DGLSolver can be used to minimize", "[CDGLSolver]") {
     CMyVector result = CMyVector::minimize(x_start, error, 0.001);
 
     std::cout << "Ergebnis: " << result.to_string() << std::endl;
+    REQUIRE_THAT(result.get(0), WithinAbs(0.725, 1e-3));
+    REQUIRE_THAT(result.get(1), WithinAbs(0.939, 1e-3));
 }
 